@@ -0,0 +1,222 @@
+// Measures heap allocations and round-trip latency per bridged operation: a coroutine
+// on the executor starts an operation, a separate "WebRTC" thread completes it through
+// a ref-counted observer, and the result is marshalled back. Compares the previous
+// AsyncBridge (shared_ptr handler, std::function observer, malloc'd post) with the
+// current one (recycled operation state, Completion observer, pooled post). The
+// coroutine frames of the benchmark's own awaitables are allocated by asio and are
+// included in both counts.
+//
+// Usage: async_bridge_bench [operations] [concurrency]
+
+#include <atomic>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <librtc/utils/async_bridge.hpp>
+#include <librtc/utils/spsc_ring.hpp>
+#include <memory>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+namespace asio = boost::asio;
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+using BenchResult = Result<int, std::error_code>;
+
+// Stand-in for a WebRTC observer: completed and released on the WebRTC thread.
+struct Observer {
+  virtual ~Observer() = default;
+  virtual void OnSuccess(int value) = 0;
+};
+
+// Stand-in for the WebRTC signaling thread. Completing never allocates, so the
+// counters only see the bridge itself.
+class FakeSignalingThread {
+ public:
+  FakeSignalingThread() : ring_(4096), thread_([this]() { run(); }) {}
+
+  ~FakeSignalingThread() {
+    stop_.store(true, std::memory_order_release);
+    thread_.join();
+  }
+
+  // Called from the executor thread only.
+  void submit(Observer* observer) {
+    while (!ring_.try_push(observer)) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  void run() {
+    while (!stop_.load(std::memory_order_acquire)) {
+      if (auto observer = ring_.try_pop()) {
+        (*observer)->OnSuccess(42);
+        delete *observer;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  SpscRing<Observer*> ring_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
+
+// AsyncBridge as it was before operation state recycling, kept for comparison.
+struct LegacyBridge {
+  struct Proxy : Observer {
+    explicit Proxy(std::function<void(BenchResult)> cb) : cb(std::move(cb)) {}
+    void OnSuccess(int value) override {
+      cb(value);
+    }
+    std::function<void(BenchResult)> cb;
+  };
+
+  static asio::awaitable<BenchResult> run(asio::any_io_executor executor,
+                                          FakeSignalingThread& thread) {
+    auto initiate = [&thread](auto cb) { thread.submit(new Proxy(std::move(cb))); };
+    auto initiation = [initiate, executor](auto handler) mutable {
+      auto shared_handler = std::make_shared<decltype(handler)>(std::move(handler));
+      auto callback = [shared_handler, executor](BenchResult res) mutable {
+        asio::post(executor, [h = std::move(*shared_handler), r = std::move(res)]() mutable {
+          h(std::move(r));
+        });
+      };
+      initiate(std::move(callback));
+    };
+    co_return co_await asio::async_initiate<decltype(asio::use_awaitable), void(BenchResult)>(
+        std::move(initiation), asio::use_awaitable);
+  }
+};
+
+struct CurrentBridge {
+  struct Proxy : Observer {
+    explicit Proxy(AsyncBridge<int>::Completion cb) : cb(std::move(cb)) {}
+    void OnSuccess(int value) override {
+      cb(value);
+    }
+    static void* operator new(std::size_t size) {
+      return detail::RecyclingPool::allocate(size);
+    }
+    static void operator delete(void* p) noexcept {
+      detail::RecyclingPool::deallocate(p);
+    }
+    AsyncBridge<int>::Completion cb;
+  };
+
+  static asio::awaitable<BenchResult> run(asio::any_io_executor executor,
+                                          FakeSignalingThread& thread) {
+    auto initiate = [&thread](auto cb) { thread.submit(new Proxy(std::move(cb))); };
+    co_return co_await AsyncBridge<int>::async_run(executor, std::move(initiate),
+                                                   asio::use_awaitable);
+  }
+};
+
+template <typename Bridge>
+asio::awaitable<void> worker(int operations, std::vector<double>& latencies_us,
+                             FakeSignalingThread& thread) {
+  auto executor = co_await asio::this_coro::executor;
+  for (int i = 0; i < operations; ++i) {
+    auto start = bench::Clock::now();
+    auto result = co_await Bridge::run(executor, thread);
+    latencies_us.push_back(bench::elapsed_ms(start) * 1000.0);
+    if (!result) {
+      std::cerr << "Bridged operation failed\n";
+    }
+  }
+}
+
+template <typename Bridge>
+std::string measure(const char* implementation, int operations, int concurrency) {
+  FakeSignalingThread thread;
+  std::vector<std::vector<double>> latencies(concurrency);
+  for (auto& samples : latencies) {
+    samples.reserve(operations / concurrency + 1);
+  }
+
+  // Warm-up fills the recycling pools and asio's own caches.
+  {
+    asio::io_context ctx;
+    std::vector<double> ignored;
+    ignored.reserve(1000);
+    asio::co_spawn(ctx, worker<Bridge>(1000, ignored, thread), asio::detached);
+    ctx.run();
+  }
+
+  asio::io_context ctx;
+  for (int i = 0; i < concurrency; ++i) {
+    asio::co_spawn(ctx, worker<Bridge>(operations / concurrency, latencies[i], thread),
+                   asio::detached);
+  }
+
+  auto allocations_before = g_allocations.load(std::memory_order_relaxed);
+  auto start = bench::Clock::now();
+  ctx.run();
+  double total_ms = bench::elapsed_ms(start);
+  auto allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+  std::vector<double> all;
+  for (auto& samples : latencies) {
+    all.insert(all.end(), samples.begin(), samples.end());
+  }
+  auto completed = all.size();
+
+  return bench::JsonObject()
+      .add("implementation", implementation)
+      .add("operations", static_cast<std::uint64_t>(completed))
+      .add("concurrency", static_cast<std::uint64_t>(concurrency))
+      .add("allocations_per_op", static_cast<double>(allocations) / completed)
+      .add("ops_per_sec", completed / (total_ms / 1000.0))
+      .add("latency_us", bench::summarize(std::move(all)))
+      .str();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int operations = argc > 1 ? std::stoi(argv[1]) : 200'000;
+  int concurrency = argc > 2 ? std::stoi(argv[2]) : 1;
+
+  std::vector<std::string> results;
+  results.push_back(measure<LegacyBridge>("legacy", operations, concurrency));
+  results.push_back(measure<CurrentBridge>("recycled", operations, concurrency));
+  std::cout << bench::json_array(results) << std::endl;
+  return 0;
+}
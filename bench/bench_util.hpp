@@ -0,0 +1,162 @@
+#pragma once
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace librtc::bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed_ms(Clock::time_point start, Clock::time_point end = Clock::now()) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+/**
+ * Resident set size of the current process, read from /proc (Linux only, 0 elsewhere).
+ */
+inline std::size_t rss_bytes() {
+  std::ifstream statm("/proc/self/statm");
+  std::size_t pages = 0;
+  std::size_t resident = 0;
+  if (!(statm >> pages >> resident)) {
+    return 0;
+  }
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * Number of threads in the current process, read from /proc (Linux only, 0 elsewhere).
+ */
+inline std::size_t thread_count() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.starts_with("Threads:")) {
+      return std::stoul(line.substr(8));
+    }
+  }
+  return 0;
+}
+
+struct Summary {
+  std::size_t count = 0;
+  double min = 0;
+  double mean = 0;
+  double p50 = 0;
+  double p99 = 0;
+  double p999 = 0;
+  double max = 0;
+};
+
+inline Summary summarize(std::vector<double> samples) {
+  Summary s;
+  if (samples.empty()) {
+    return s;
+  }
+  std::sort(samples.begin(), samples.end());
+  auto at = [&](double q) {
+    auto index = static_cast<std::size_t>(q * static_cast<double>(samples.size() - 1));
+    return samples[index];
+  };
+  double sum = 0;
+  for (double v : samples) {
+    sum += v;
+  }
+  s.count = samples.size();
+  s.min = samples.front();
+  s.mean = sum / static_cast<double>(samples.size());
+  s.p50 = at(0.50);
+  s.p99 = at(0.99);
+  s.p999 = at(0.999);
+  s.max = samples.back();
+  return s;
+}
+
+/**
+ * Minimal builder for one JSON object. Values added with add_raw() are emitted
+ * verbatim, which allows nesting objects and arrays.
+ */
+class JsonObject {
+ public:
+  JsonObject& add(std::string_view key, std::string_view value) {
+    std::string quoted = "\"";
+    for (char c : value) {
+      if (c == '"' || c == '\\') {
+        quoted += '\\';
+      }
+      quoted += c;
+    }
+    quoted += '"';
+    return add_raw(key, quoted);
+  }
+
+  JsonObject& add(std::string_view key, const char* value) {
+    return add(key, std::string_view(value));
+  }
+
+  JsonObject& add(std::string_view key, bool value) {
+    return add_raw(key, value ? "true" : "false");
+  }
+
+  JsonObject& add(std::string_view key, double value) {
+    std::ostringstream out;
+    out << value;
+    return add_raw(key, out.str());
+  }
+
+  JsonObject& add(std::string_view key, std::uint64_t value) {
+    return add_raw(key, std::to_string(value));
+  }
+
+  JsonObject& add(std::string_view key, const Summary& summary) {
+    return add_raw(key, JsonObject()
+                            .add("count", static_cast<std::uint64_t>(summary.count))
+                            .add("min", summary.min)
+                            .add("mean", summary.mean)
+                            .add("p50", summary.p50)
+                            .add("p99", summary.p99)
+                            .add("p999", summary.p999)
+                            .add("max", summary.max)
+                            .str());
+  }
+
+  JsonObject& add_raw(std::string_view key, std::string_view json) {
+    if (!body_.empty()) {
+      body_ += ", ";
+    }
+    body_ += '"';
+    body_ += key;
+    body_ += "\": ";
+    body_ += json;
+    return *this;
+  }
+
+  std::string str() const {
+    return "{" + body_ + "}";
+  }
+
+ private:
+  std::string body_;
+};
+
+inline std::string json_array(const std::vector<std::string>& items) {
+  std::string out = "[";
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    if (i > 0) {
+      out += ",\n  ";
+    }
+    out += items[i];
+  }
+  return out + "]";
+}
+
+}  // namespace librtc::bench
@@ -0,0 +1,255 @@
+// Ramps the number of open PeerConnections, each with one data channel, and records
+// per-connection cost at every step: PeerConnection::Create latency, time to ICE
+// Connected and to DataChannel Open, process thread count and RSS. Connections are set
+// up as loopback pairs with librtc::testing, so N connections are N/2 pairs, and every
+// connection stays open until the ramp ends.
+//
+// Usage: connection_scale_bench [max-connections] [option=value ...]
+//   profile=full|data-only  factory profile (data-only)
+//   shards=N                network/worker thread pairs, 0 for one per CPU (0)
+//   pin=0|1                 pin shard threads to CPUs (0)
+//   templates=0|1           description templates (0)
+//   delivery=direct|executor  event delivery (direct)
+//   batch-window=MS         ice_candidate_batch_window (0)
+//   network=host|virtual    host interfaces or the in-process virtual network (host);
+//                           the virtual network always runs a single shard
+//   concurrency=N           pairs set up in parallel (8)
+
+#include <sys/resource.h>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
+#include <librtc/testing/loopback.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+namespace asio = boost::asio;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::size_t kSteps[] = {2, 10, 100, 1000, 10000};
+
+struct Options {
+  std::size_t max_connections = 10000;
+  FactoryProfile profile = FactoryProfile::DataOnly;
+  std::size_t shards = 0;
+  bool pin = false;
+  bool templates = false;
+  bool executor_delivery = false;
+  std::chrono::milliseconds batch_window{0};
+  bool virtual_network = false;
+  std::size_t concurrency = 8;
+};
+
+bool parse_option(std::string_view arg, Options& options) {
+  auto eq = arg.find('=');
+  if (eq == std::string_view::npos) {
+    return false;
+  }
+  auto key = arg.substr(0, eq);
+  auto value = std::string(arg.substr(eq + 1));
+  if (key == "profile" && (value == "full" || value == "data-only")) {
+    options.profile = value == "full" ? FactoryProfile::Full : FactoryProfile::DataOnly;
+  } else if (key == "shards") {
+    options.shards = std::stoul(value);
+  } else if (key == "pin") {
+    options.pin = value == "1";
+  } else if (key == "templates") {
+    options.templates = value == "1";
+  } else if (key == "delivery" && (value == "direct" || value == "executor")) {
+    options.executor_delivery = value == "executor";
+  } else if (key == "batch-window") {
+    options.batch_window = std::chrono::milliseconds(std::stol(value));
+  } else if (key == "network" && (value == "host" || value == "virtual")) {
+    options.virtual_network = value == "virtual";
+  } else if (key == "concurrency" && std::stoul(value) > 0) {
+    options.concurrency = std::stoul(value);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Thousands of connections on host interfaces need more descriptors than the usual
+// soft limit of 1024.
+void raise_fd_limit() {
+  rlimit limit{};
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+double to_ms(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Samples of the pairs set up since the last step.
+struct Step {
+  std::vector<double> create_ms;
+  std::vector<double> connected_ms;
+  std::vector<double> open_ms;
+  std::uint64_t failures = 0;
+};
+
+struct Ramp {
+  std::vector<testing::LoopbackPair> pairs;
+  Step step;
+  std::size_t target_pairs = 0;
+  std::size_t started = 0;
+  std::size_t running = 0;
+};
+
+asio::awaitable<void> setup_worker(std::shared_ptr<RtcContext> context,
+                                   testing::LoopbackPairConfig config, Ramp& ramp) {
+  while (ramp.started < ramp.target_pairs) {
+    ++ramp.started;
+    auto pair = co_await testing::make_loopback_pair(context, config);
+    if (!pair) {
+      ++ramp.step.failures;
+      continue;
+    }
+    // Create covers both connections of the pair.
+    ramp.step.create_ms.push_back(to_ms(pair.value().create_time) / 2);
+    ramp.step.connected_ms.push_back(to_ms(pair.value().connect_time));
+    ramp.step.open_ms.push_back(to_ms(pair.value().open_time));
+    ramp.pairs.push_back(std::move(pair).value());
+  }
+  --ramp.running;
+}
+
+asio::awaitable<void> run_ramp(std::shared_ptr<RtcContext> context, Options options,
+                               std::vector<std::string>& results) {
+  auto executor = co_await asio::this_coro::executor;
+  testing::LoopbackPairConfig config;
+  config.peer.ice.candidate_filter = IceCandidateFilter::HostOnly;
+  config.peer.ice.tcp_candidates = false;
+  config.peer.description_templates = options.templates;
+  config.peer.ice_candidate_batch_window = options.batch_window;
+  if (options.executor_delivery) {
+    config.peer.event_delivery = {.mode = EventDelivery::Executor};
+  }
+  config.timeout = 30s;
+
+  auto rss_base = bench::rss_bytes();
+  auto threads_base = bench::thread_count();
+  std::vector<std::size_t> steps;
+  for (auto step : kSteps) {
+    if (step < options.max_connections) {
+      steps.push_back(step);
+    }
+  }
+  steps.push_back(options.max_connections);
+
+  Ramp ramp;
+  asio::steady_timer timer(executor);
+  for (auto connections : steps) {
+    ramp.target_pairs = (connections + 1) / 2;
+    ramp.step = {};
+    auto start = bench::Clock::now();
+    auto workers = std::min(options.concurrency, ramp.target_pairs - ramp.started);
+    ramp.running = workers;
+    for (std::size_t i = 0; i < workers; ++i) {
+      asio::co_spawn(executor, setup_worker(context, config, ramp), asio::detached);
+    }
+    while (ramp.running > 0) {
+      timer.expires_after(1ms);
+      co_await timer.async_wait(asio::use_awaitable);
+    }
+
+    auto open_connections = ramp.pairs.size() * 2;
+    auto rss = bench::rss_bytes();
+    auto threads = bench::thread_count();
+    auto grown = rss > rss_base ? rss - rss_base : 0;
+    auto attempted = ramp.step.create_ms.size() + ramp.step.failures;
+    results.push_back(
+        bench::JsonObject()
+            .add("connections", static_cast<std::uint64_t>(open_connections))
+            .add("failed_pairs", ramp.step.failures)
+            .add("step_seconds", bench::elapsed_ms(start) / 1e3)
+            .add("create_ms", bench::summarize(std::move(ramp.step.create_ms)))
+            .add("time_to_connected_ms", bench::summarize(std::move(ramp.step.connected_ms)))
+            .add("time_to_open_ms", bench::summarize(std::move(ramp.step.open_ms)))
+            .add("threads", static_cast<std::uint64_t>(threads))
+            .add("threads_added", static_cast<std::uint64_t>(
+                                      threads > threads_base ? threads - threads_base : 0))
+            .add("rss_bytes", static_cast<std::uint64_t>(rss))
+            .add("rss_per_connection_bytes",
+                 static_cast<std::uint64_t>(open_connections ? grown / open_connections : 0))
+            .str());
+
+    // Stop ramping once most setups fail: the limit has been reached.
+    if (attempted > 0 && ramp.step.failures * 2 > attempted) {
+      break;
+    }
+  }
+
+  for (auto& pair : ramp.pairs) {
+    pair.offerer->close();
+    pair.answerer->close();
+  }
+  ramp.pairs.clear();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (i == 1 && arg.find('=') == std::string_view::npos) {
+      options.max_connections = std::stoul(std::string(arg));
+    } else if (!parse_option(arg, options)) {
+      std::cerr << "Unknown option: " << arg << "\n";
+      return 2;
+    }
+  }
+  raise_fd_limit();
+
+  RtcContextConfig context_config{.profile = options.profile,
+                                  .shard_count = options.shards,
+                                  .pin_shards = options.pin};
+  auto context_res = options.virtual_network
+                         ? testing::make_loopback_context({}, context_config)
+                         : RtcContext::Create(context_config);
+  if (!context_res) {
+    std::cerr << "Context creation failed: " << context_res.error().message() << "\n";
+    return 1;
+  }
+  auto shard_count = context_res.value()->shard_count();
+
+  std::vector<std::string> results;
+  asio::io_context ctx;
+  asio::co_spawn(ctx, run_ramp(context_res.value(), options, results), asio::detached);
+  ctx.run();
+
+  std::cout << bench::JsonObject()
+                   .add("profile", options.profile == FactoryProfile::Full ? "full" : "data-only")
+                   .add("shards", static_cast<std::uint64_t>(shard_count))
+                   .add("pin_shards", options.pin)
+                   .add("description_templates", options.templates)
+                   .add("event_delivery", options.executor_delivery ? "executor" : "direct")
+                   .add("ice_candidate_batch_window_ms",
+                        static_cast<std::uint64_t>(options.batch_window.count()))
+                   .add("network", options.virtual_network ? "virtual" : "host")
+                   .add("concurrency", static_cast<std::uint64_t>(options.concurrency))
+                   .add_raw("steps", bench::json_array(results))
+                   .str()
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,285 @@
+// Measures DataChannel throughput and one-way latency over a loopback connection pair:
+// messages/sec, MB/sec and p50/p99/p999 latency from DataChannel::async_send to
+// on_message, across message sizes, ordered vs. unordered, reliable vs.
+// max_retransmits=0 and 1 to 64 concurrent channels. Every channel sends as fast as
+// backpressure allows, so latency includes queueing in the send buffers.
+//
+// Usage: data_channel_bench [max-messages] [host|virtual]
+// "host" (default) runs over the host's interfaces with host-only candidates,
+// "virtual" over librtc::testing's in-process virtual network.
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <librtc/buffer.hpp>
+#include <librtc/data_channel.hpp>
+#include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
+#include <librtc/testing/loopback.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+namespace asio = boost::asio;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::size_t kMessageSizes[] = {16, 256, 4 * 1024, 64 * 1024, 256 * 1024};
+constexpr std::size_t kChannelCounts[] = {1, 4, 16, 64};
+// Bytes sent per case before max-messages caps it.
+constexpr std::size_t kBytesPerCase = 64 * 1024 * 1024;
+constexpr std::size_t kMinMessagesPerCase = 100;
+// A case ends when everything has arrived, or when nothing has arrived for this long
+// after the last send (lost unreliable messages).
+constexpr auto kIdleTimeout = 500ms;
+// Negotiated channel ids start here, clear of the pair's own channel.
+constexpr int kFirstChannelId = 100;
+
+struct Mode {
+  bool ordered;
+  bool reliable;
+};
+
+// Every message starts with its send time and the index of the case that sent it, so
+// late messages of a previous case are not counted.
+struct Header {
+  std::int64_t sent_ns;
+  std::uint32_t round;
+};
+static_assert(sizeof(Header) <= 16);
+
+std::int64_t now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             bench::Clock::now().time_since_epoch())
+      .count();
+}
+
+// Fed by on_message on the network thread, read by the benchmark between cases.
+struct Receiver {
+  std::mutex mutex;
+  std::uint32_t round = 0;
+  std::vector<double> latency_ms;
+  std::uint64_t bytes = 0;
+  std::int64_t last_ns = 0;
+  std::atomic<std::uint64_t> received{0};
+
+  void on_message(DataChannel::MessageBuffer data) {
+    if (data.size() < sizeof(Header)) {
+      return;
+    }
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    auto now = now_ns();
+    std::lock_guard lock(mutex);
+    if (header.round != round) {
+      return;
+    }
+    latency_ms.push_back(static_cast<double>(now - header.sent_ns) / 1e6);
+    bytes += data.size();
+    last_ns = now;
+    received.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void reset(std::uint32_t next_round) {
+    std::lock_guard lock(mutex);
+    round = next_round;
+    latency_ms.clear();
+    bytes = 0;
+    last_ns = 0;
+    received.store(0, std::memory_order_relaxed);
+  }
+};
+
+struct Senders {
+  std::uint64_t sent = 0;
+  std::uint64_t errors = 0;
+  std::size_t finished = 0;
+};
+
+asio::awaitable<void> send_messages(std::shared_ptr<DataChannel> channel, std::size_t size,
+                                    std::uint32_t round, std::uint64_t count, Senders& senders) {
+  for (std::uint64_t i = 0; i < count; ++i) {
+    Buffer message(size);
+    Header header{.sent_ns = now_ns(), .round = round};
+    std::memcpy(message.mutable_data().data(), &header, sizeof(header));
+    if (!co_await channel->async_send(std::move(message))) {
+      ++senders.errors;
+      break;
+    }
+    ++senders.sent;
+  }
+  ++senders.finished;
+}
+
+bool all_open(const std::vector<std::shared_ptr<DataChannel>>& channels) {
+  return std::all_of(channels.begin(), channels.end(), [](const auto& channel) {
+    return channel->state() == DataChannelState::Open;
+  });
+}
+
+asio::awaitable<void> run_case(const std::vector<std::shared_ptr<DataChannel>>& senders_side,
+                               Receiver& receiver, Mode mode, std::size_t size,
+                               std::uint32_t round, std::size_t max_messages,
+                               std::vector<std::string>& results) {
+  auto executor = co_await asio::this_coro::executor;
+  auto channel_count = senders_side.size();
+  auto total = std::min(max_messages, std::max(kMinMessagesPerCase, kBytesPerCase / size));
+  auto per_channel = std::max<std::uint64_t>(1, total / channel_count);
+
+  receiver.reset(round);
+  Senders senders;
+  auto start = bench::Clock::now();
+  auto start_ns = now_ns();
+  for (const auto& channel : senders_side) {
+    asio::co_spawn(executor, send_messages(channel, size, round, per_channel, senders),
+                   asio::detached);
+  }
+
+  asio::steady_timer timer(executor);
+  std::uint64_t last_received = 0;
+  auto last_progress = bench::Clock::now();
+  while (true) {
+    auto received = receiver.received.load(std::memory_order_relaxed);
+    if (received != last_received) {
+      last_received = received;
+      last_progress = bench::Clock::now();
+    }
+    bool sending = senders.finished < channel_count;
+    bool idle = bench::Clock::now() - last_progress > kIdleTimeout;
+    if (!sending && (received >= senders.sent || idle)) {
+      break;
+    }
+    timer.expires_after(1ms);
+    co_await timer.async_wait(asio::use_awaitable);
+  }
+
+  std::lock_guard lock(receiver.mutex);
+  auto received = static_cast<std::uint64_t>(receiver.latency_ms.size());
+  double seconds = receiver.last_ns > start_ns
+                       ? static_cast<double>(receiver.last_ns - start_ns) / 1e9
+                       : bench::elapsed_ms(start) / 1e3;
+  results.push_back(
+      bench::JsonObject()
+          .add("message_size", static_cast<std::uint64_t>(size))
+          .add("ordered", mode.ordered)
+          .add("reliable", mode.reliable)
+          .add("channels", static_cast<std::uint64_t>(channel_count))
+          .add("sent", senders.sent)
+          .add("received", received)
+          .add("send_errors", senders.errors)
+          .add("seconds", seconds)
+          .add("messages_per_sec", static_cast<double>(received) / seconds)
+          .add("mb_per_sec", static_cast<double>(receiver.bytes) / 1e6 / seconds)
+          .add("latency_ms", bench::summarize(std::move(receiver.latency_ms)))
+          .str());
+}
+
+// One connection pair with channel_count negotiated channels in the given mode, used for
+// every message size.
+asio::awaitable<void> run_mode(std::shared_ptr<RtcContext> context, Mode mode,
+                               std::size_t channel_count, std::size_t max_messages,
+                               std::uint32_t& round, std::vector<std::string>& results) {
+  auto executor = co_await asio::this_coro::executor;
+  testing::LoopbackPairConfig config;
+  config.peer.ice.candidate_filter = IceCandidateFilter::HostOnly;
+  config.peer.ice.tcp_candidates = false;
+  auto pair_res = co_await testing::make_loopback_pair(context, config);
+  if (!pair_res) {
+    std::cerr << "Loopback pair failed: " << pair_res.error().message() << "\n";
+    co_return;
+  }
+  auto pair = std::move(pair_res).value();
+
+  DataChannelConfig channel_config{.ordered = mode.ordered, .negotiated = true};
+  if (!mode.reliable) {
+    channel_config.max_retransmits = 0;
+  }
+  std::vector<std::shared_ptr<DataChannel>> senders_side;
+  std::vector<std::shared_ptr<DataChannel>> receivers_side;
+  for (std::size_t i = 0; i < channel_count; ++i) {
+    auto label = "bench-" + std::to_string(i);
+    channel_config.id = kFirstChannelId + static_cast<int>(i);
+    auto sender = pair.offerer->create_data_channel(label, channel_config);
+    auto receiver = pair.answerer->create_data_channel(label, channel_config);
+    if (!sender || !receiver) {
+      std::cerr << "DataChannel creation failed\n";
+      co_return;
+    }
+    senders_side.push_back(std::move(sender).value());
+    receivers_side.push_back(std::move(receiver).value());
+  }
+
+  asio::steady_timer timer(executor);
+  auto deadline = bench::Clock::now() + 10s;
+  while (!(all_open(senders_side) && all_open(receivers_side))) {
+    if (bench::Clock::now() > deadline) {
+      std::cerr << "Channels did not open\n";
+      co_return;
+    }
+    timer.expires_after(1ms);
+    co_await timer.async_wait(asio::use_awaitable);
+  }
+
+  Receiver receiver;
+  std::vector<Subscription> subscriptions;
+  for (const auto& channel : receivers_side) {
+    subscriptions.push_back(channel->on_message().connect_raw(
+        &receiver, [](Receiver& r, DataChannel::MessageBuffer data, bool) { r.on_message(data); }));
+  }
+
+  for (auto size : kMessageSizes) {
+    co_await run_case(senders_side, receiver, mode, size, ++round, max_messages, results);
+  }
+
+  // Stop delivery into receiver before it goes away.
+  pair.offerer->close();
+  pair.answerer->close();
+  subscriptions.clear();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t max_messages = argc > 1 ? std::stoul(argv[1]) : 20000;
+  std::string network = argc > 2 ? argv[2] : "host";
+
+  auto context_res = network == "virtual"
+                         ? testing::make_loopback_context({}, {.profile = FactoryProfile::DataOnly})
+                         : RtcContext::Create({.profile = FactoryProfile::DataOnly});
+  if (!context_res) {
+    std::cerr << "Context creation failed: " << context_res.error().message() << "\n";
+    return 1;
+  }
+
+  std::vector<std::string> results;
+  std::uint32_t round = 0;
+  for (auto mode : {Mode{true, true}, Mode{false, true}, Mode{true, false}, Mode{false, false}}) {
+    for (auto channel_count : kChannelCounts) {
+      asio::io_context ctx;
+      asio::co_spawn(
+          ctx, run_mode(context_res.value(), mode, channel_count, max_messages, round, results),
+          asio::detached);
+      ctx.run();
+    }
+  }
+  std::cout << bench::JsonObject()
+                   .add("network", network)
+                   .add_raw("results", bench::json_array(results))
+                   .str()
+            << std::endl;
+  return 0;
+}
@@ -0,0 +1,212 @@
+// Compares the cost of EventSource::emit against the previous implementation, which
+// locked a mutex and copied every handler into a fresh vector on each emission.
+// Reports nanoseconds and heap allocations per emit for 1, 4 and 16 subscribers,
+// using the on_message signature, for weak_ptr-tracked and connect_raw subscribers,
+// and the cost of a subscribe/emit/unsubscribe cycle next to 16 long-lived subscribers.
+//
+// Usage: event_emit_bench [emits]
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <librtc/utils/event.hpp>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+// EventSource as it was before snapshots and inline handlers, kept for comparison:
+// handlers are std::function, and emit locks a mutex and copies all of them.
+template <typename... Args>
+class LegacyEventSource {
+ public:
+  using Handler = std::function<void(Args...)>;
+
+  template <typename T, typename F>
+  void connect(std::weak_ptr<T> context, F&& handler) {
+    std::lock_guard lock(mutex_);
+    subscriptions_.push_back(
+        {context, [context, handler = std::forward<F>(handler)](Args... args) mutable {
+           if (auto locked = context.lock()) {
+             handler(*locked, std::forward<Args>(args)...);
+           }
+         }});
+  }
+
+  template <typename T, typename F>
+  void operator()(std::weak_ptr<T> context, F&& handler) {
+    connect(std::move(context), std::forward<F>(handler));
+  }
+
+  void emit(Args... args) {
+    std::vector<Handler> targets;
+    {
+      std::lock_guard lock(mutex_);
+      for (auto it = subscriptions_.begin(); it != subscriptions_.end();) {
+        if (it->tracker.expired()) {
+          it = subscriptions_.erase(it);
+        } else {
+          targets.push_back(it->handler);
+          ++it;
+        }
+      }
+    }
+
+    for (auto& handler : targets) {
+      handler(args...);
+    }
+  }
+
+ private:
+  struct Subscription {
+    std::weak_ptr<void> tracker;
+    Handler handler;
+  };
+
+  std::mutex mutex_;
+  std::vector<Subscription> subscriptions_;
+};
+
+enum class Mode { Weak, Raw };
+
+struct Consumer {
+  std::uint64_t bytes = 0;
+};
+
+template <typename Source>
+std::string measure(const char* implementation, Mode mode, int subscribers, int emits) {
+  Source source;
+  std::vector<std::shared_ptr<Consumer>> consumers;
+  std::vector<Subscription> subscriptions;
+  auto handler = [](Consumer& self, std::span<const std::byte> data, bool) {
+    self.bytes += data.size();
+  };
+  for (int i = 0; i < subscribers; ++i) {
+    auto consumer = std::make_shared<Consumer>();
+    if constexpr (requires { source.connect_raw(consumer.get(), handler); }) {
+      if (mode == Mode::Raw) {
+        subscriptions.push_back(source.connect_raw(consumer.get(), handler));
+      } else {
+        subscriptions.push_back(source.subscribe(std::weak_ptr<Consumer>(consumer), handler));
+      }
+    } else {
+      source.connect(std::weak_ptr<Consumer>(consumer), handler);
+    }
+    consumers.push_back(std::move(consumer));
+  }
+
+  std::vector<std::byte> payload(1200);
+  std::span<const std::byte> data(payload);
+
+  // Warm up caches and any lazily allocated state.
+  for (int i = 0; i < 1000; ++i) {
+    source.emit(data, true);
+  }
+
+  auto allocations_before = g_allocations.load(std::memory_order_relaxed);
+  auto start = bench::Clock::now();
+  for (int i = 0; i < emits; ++i) {
+    source.emit(data, true);
+  }
+  double total_ms = bench::elapsed_ms(start);
+  auto allocations = g_allocations.load(std::memory_order_relaxed) - allocations_before;
+
+  return bench::JsonObject()
+      .add("implementation", implementation)
+      .add("subscribers", static_cast<std::uint64_t>(subscribers))
+      .add("emits", static_cast<std::uint64_t>(emits))
+      .add("ns_per_emit", total_ms * 1e6 / emits)
+      .add("allocations_per_emit", static_cast<double>(allocations) / emits)
+      .str();
+}
+
+// Short-lived consumers subscribing to a long-lived source: each cycle connects one,
+// emits once and drops it, next to 16 permanent subscribers.
+template <typename Source>
+std::string measure_churn(const char* implementation, int cycles) {
+  Source source;
+  auto handler = [](Consumer& self, std::span<const std::byte> data, bool) {
+    self.bytes += data.size();
+  };
+  std::vector<std::shared_ptr<Consumer>> permanent;
+  for (int i = 0; i < 16; ++i) {
+    permanent.push_back(std::make_shared<Consumer>());
+    source(std::weak_ptr<Consumer>(permanent.back()), handler);
+  }
+
+  std::vector<std::byte> payload(1200);
+  std::span<const std::byte> data(payload);
+
+  auto start = bench::Clock::now();
+  for (int i = 0; i < cycles; ++i) {
+    auto consumer = std::make_shared<Consumer>();
+    if constexpr (requires { source.connect_raw(consumer.get(), handler); }) {
+      auto subscription = source.subscribe(std::weak_ptr<Consumer>(consumer), handler);
+      source.emit(data, true);
+    } else {
+      source.connect(std::weak_ptr<Consumer>(consumer), handler);
+      source.emit(data, true);
+    }
+  }
+  double total_ms = bench::elapsed_ms(start);
+
+  return bench::JsonObject()
+      .add("implementation", implementation)
+      .add("scenario", "churn")
+      .add("cycles", static_cast<std::uint64_t>(cycles))
+      .add("ns_per_cycle", total_ms * 1e6 / cycles)
+      .str();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int emits = argc > 1 ? std::stoi(argv[1]) : 1'000'000;
+
+  using Signature = EventSource<std::span<const std::byte>, bool>;
+  using LegacySignature = LegacyEventSource<std::span<const std::byte>, bool>;
+
+  std::vector<std::string> results;
+  for (int subscribers : {1, 4, 16}) {
+    results.push_back(measure<LegacySignature>("legacy", Mode::Weak, subscribers, emits));
+    results.push_back(measure<Signature>("snapshot", Mode::Weak, subscribers, emits));
+    results.push_back(measure<Signature>("snapshot_raw", Mode::Raw, subscribers, emits));
+  }
+  results.push_back(measure_churn<LegacySignature>("legacy", emits / 10));
+  results.push_back(measure_churn<Signature>("snapshot", emits / 10));
+  std::cout << bench::json_array(results) << std::endl;
+  return 0;
+}
@@ -0,0 +1,132 @@
+// Compares the Full and DataOnly factory profiles: time from RtcContext::Create until
+// the first PeerConnection has a local offer applied ("create-to-ready"), per-connection
+// setup latency, and resident memory.
+//
+// Usage: factory_profile_bench [full|data-only] [connections]
+// Without a profile argument both profiles are measured, each in a forked child so
+// that the RSS numbers do not contaminate each other.
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <iostream>
+#include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+namespace asio = boost::asio;
+
+namespace {
+
+asio::awaitable<void> run_profile(FactoryProfile profile, int connections) {
+  auto executor = co_await asio::this_coro::executor;
+  auto rss_start = bench::rss_bytes();
+  auto start = bench::Clock::now();
+
+  auto context_res = RtcContext::Create({.profile = profile});
+  if (!context_res) {
+    std::cerr << "Context creation failed: " << context_res.error().message() << "\n";
+    co_return;
+  }
+  auto context = context_res.value();
+  double context_ms = bench::elapsed_ms(start);
+  auto rss_context = bench::rss_bytes();
+
+  std::vector<std::shared_ptr<PeerConnection>> pcs;
+  std::vector<std::shared_ptr<DataChannel>> channels;
+  std::vector<double> setup_ms;
+  double first_ready_ms = 0;
+
+  for (int i = 0; i < connections; ++i) {
+    auto pc_start = bench::Clock::now();
+    auto pc_res = PeerConnection::Create(context, executor);
+    if (!pc_res) {
+      std::cerr << "PeerConnection creation failed\n";
+      co_return;
+    }
+    auto pc = pc_res.value();
+    auto dc_res = pc->create_data_channel("bench");
+    if (!dc_res) {
+      std::cerr << "DataChannel creation failed\n";
+      co_return;
+    }
+
+    auto offer = co_await pc->create_offer();
+    if (!offer || !co_await pc->set_local_description(offer.value())) {
+      std::cerr << "Offer failed\n";
+      co_return;
+    }
+
+    setup_ms.push_back(bench::elapsed_ms(pc_start));
+    if (i == 0) {
+      first_ready_ms = bench::elapsed_ms(start);
+    }
+    pcs.push_back(std::move(pc));
+    channels.push_back(dc_res.value());
+  }
+
+  auto rss_end = bench::rss_bytes();
+  auto grown = rss_end > rss_context ? rss_end - rss_context : 0;
+  auto per_connection = connections > 0 ? grown / connections : 0;
+
+  std::cout << bench::JsonObject()
+                   .add("profile", profile == FactoryProfile::Full ? "full" : "data-only")
+                   .add("connections", static_cast<std::uint64_t>(connections))
+                   .add("context_create_ms", context_ms)
+                   .add("create_to_ready_ms", first_ready_ms)
+                   .add("connection_setup_ms", bench::summarize(setup_ms))
+                   .add("rss_start_bytes", static_cast<std::uint64_t>(rss_start))
+                   .add("rss_context_bytes", static_cast<std::uint64_t>(rss_context))
+                   .add("rss_end_bytes", static_cast<std::uint64_t>(rss_end))
+                   .add("rss_per_connection_bytes", static_cast<std::uint64_t>(per_connection))
+                   .add("threads", static_cast<std::uint64_t>(bench::thread_count()))
+                   .str()
+            << std::endl;
+
+  channels.clear();
+  for (auto& pc : pcs) {
+    pc->close();
+  }
+  pcs.clear();
+}
+
+int run(FactoryProfile profile, int connections) {
+  asio::io_context ctx;
+  asio::co_spawn(ctx, run_profile(profile, connections), asio::detached);
+  ctx.run();
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string_view profile_arg = argc > 1 ? argv[1] : "";
+  int connections = argc > 2 ? std::stoi(argv[2]) : 10;
+
+  if (profile_arg == "full") {
+    return run(FactoryProfile::Full, connections);
+  }
+  if (profile_arg == "data-only") {
+    return run(FactoryProfile::DataOnly, connections);
+  }
+
+  for (auto profile : {FactoryProfile::Full, FactoryProfile::DataOnly}) {
+    std::cout.flush();
+    pid_t child = fork();
+    if (child == 0) {
+      return run(profile, connections);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+  }
+  return 0;
+}
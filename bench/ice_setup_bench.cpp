@@ -0,0 +1,171 @@
+// Measures time-to-connected of a loopback connection pair for host-only and full ICE
+// gathering: from the first offer until both sides report Connected, with candidates
+// exchanged in batches as they are gathered.
+//
+// Usage: ice_setup_bench [iterations] [stun-url]
+// Without a STUN URL, "full" gathers host and TCP candidates only.
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <chrono>
+#include <iostream>
+#include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+namespace asio = boost::asio;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Mode {
+  const char* name;
+  IceCandidateFilter filter;
+  bool tcp_candidates;
+};
+
+struct Setup {
+  double connected_ms = 0;
+  std::size_t candidates = 0;
+};
+
+bool connected(const PeerConnection& pc) {
+  auto state = pc.ice_connection_state();
+  return state == IceConnectionState::Connected || state == IceConnectionState::Completed;
+}
+
+asio::awaitable<std::optional<Setup>> connect_pair(std::shared_ptr<RtcContext> context,
+                                                   const PeerConnectionConfig& config) {
+  auto executor = co_await asio::this_coro::executor;
+  auto a_res = PeerConnection::Create(context, executor, config);
+  auto b_res = PeerConnection::Create(context, executor, config);
+  if (!a_res || !b_res) {
+    std::cerr << "PeerConnection creation failed\n";
+    co_return std::nullopt;
+  }
+  auto a = a_res.value();
+  auto b = b_res.value();
+
+  // Handlers run on this executor, so the outboxes need no locking.
+  std::vector<IceCandidate> a_out;
+  std::vector<IceCandidate> b_out;
+  auto collect = [](std::vector<IceCandidate>& out, const IceCandidateBatch& batch) {
+    out.insert(out.end(), batch.candidates.begin(), batch.candidates.end());
+  };
+  auto a_sub = a->on_ice_candidates().connect_raw(&a_out, collect);
+  auto b_sub = b->on_ice_candidates().connect_raw(&b_out, collect);
+
+  auto dc_res = a->create_data_channel("bench");
+  if (!dc_res) {
+    std::cerr << "DataChannel creation failed\n";
+    co_return std::nullopt;
+  }
+
+  auto start = bench::Clock::now();
+  auto offer = co_await a->offer_and_set_local();
+  if (!offer || !co_await b->set_remote_description(std::move(offer).value())) {
+    std::cerr << "Offer failed\n";
+    co_return std::nullopt;
+  }
+  auto answer = co_await b->answer_and_set_local();
+  if (!answer || !co_await a->set_remote_description(std::move(answer).value())) {
+    std::cerr << "Answer failed\n";
+    co_return std::nullopt;
+  }
+
+  Setup setup;
+  asio::steady_timer timer(executor);
+  while (!(connected(*a) && connected(*b))) {
+    if (bench::Clock::now() - start > 10s) {
+      std::cerr << "Connection timed out\n";
+      co_return std::nullopt;
+    }
+    if (!a_out.empty()) {
+      auto batch = std::exchange(a_out, {});
+      setup.candidates += batch.size();
+      (void)co_await b->add_ice_candidates(batch);
+    }
+    if (!b_out.empty()) {
+      auto batch = std::exchange(b_out, {});
+      setup.candidates += batch.size();
+      (void)co_await a->add_ice_candidates(batch);
+    }
+    timer.expires_after(1ms);
+    co_await timer.async_wait(asio::use_awaitable);
+  }
+  setup.connected_ms = bench::elapsed_ms(start);
+
+  a->close();
+  b->close();
+  co_return setup;
+}
+
+asio::awaitable<void> run_mode(std::shared_ptr<RtcContext> context, Mode mode, int iterations,
+                               std::optional<std::string> stun_url,
+                               std::vector<std::string>& results) {
+  PeerConnectionConfig config;
+  config.event_delivery = {.mode = EventDelivery::Executor};
+  config.ice.candidate_filter = mode.filter;
+  config.ice.tcp_candidates = mode.tcp_candidates;
+  if (stun_url) {
+    config.ice_servers.push_back({.urls = {*stun_url}});
+  }
+
+  std::vector<double> connected_ms;
+  double candidates = 0;
+  std::uint64_t failures = 0;
+  for (int i = 0; i < iterations; ++i) {
+    auto setup = co_await connect_pair(context, config);
+    if (!setup) {
+      ++failures;
+      continue;
+    }
+    connected_ms.push_back(setup->connected_ms);
+    candidates += static_cast<double>(setup->candidates);
+  }
+
+  auto completed = connected_ms.size();
+  results.push_back(bench::JsonObject()
+                        .add("mode", mode.name)
+                        .add("iterations", static_cast<std::uint64_t>(iterations))
+                        .add("failures", failures)
+                        .add("candidates_per_pair", completed ? candidates / completed : 0.0)
+                        .add("time_to_connected_ms", bench::summarize(std::move(connected_ms)))
+                        .str());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int iterations = argc > 1 ? std::stoi(argv[1]) : 20;
+  std::optional<std::string> stun_url;
+  if (argc > 2) {
+    stun_url = argv[2];
+  }
+
+  auto context_res = RtcContext::Create({.profile = FactoryProfile::DataOnly});
+  if (!context_res) {
+    std::cerr << "Context creation failed: " << context_res.error().message() << "\n";
+    return 1;
+  }
+
+  std::vector<std::string> results;
+  for (auto mode : {Mode{"host-only", IceCandidateFilter::HostOnly, false},
+                    Mode{"full", IceCandidateFilter::All, true}}) {
+    asio::io_context ctx;
+    asio::co_spawn(ctx, run_mode(context_res.value(), mode, iterations, stun_url, results),
+                   asio::detached);
+    ctx.run();
+  }
+  std::cout << bench::json_array(results) << std::endl;
+  return 0;
+}
@@ -0,0 +1,94 @@
+// Measures initial offer creation with and without description templates. Every
+// connection gets one data channel and creates one offer; connections are created up
+// front so that only create_offer is timed. With templates, the first offer runs JSEP
+// and every later one is a patched copy of it.
+//
+// Usage: offer_cache_bench [connections]
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <iostream>
+#include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
+#include <string>
+#include <vector>
+
+#include "bench_util.hpp"
+
+using namespace librtc;
+namespace asio = boost::asio;
+
+namespace {
+
+asio::awaitable<void> measure(std::shared_ptr<RtcContext> context, bool templates,
+                              int connections, std::vector<std::string>& results) {
+  auto executor = co_await asio::this_coro::executor;
+
+  std::vector<std::shared_ptr<PeerConnection>> pcs;
+  std::vector<std::shared_ptr<DataChannel>> channels;
+  for (int i = 0; i < connections; ++i) {
+    auto pc_res =
+        PeerConnection::Create(context, executor, {.description_templates = templates});
+    if (!pc_res) {
+      std::cerr << "PeerConnection creation failed\n";
+      co_return;
+    }
+    auto dc_res = pc_res.value()->create_data_channel("bench");
+    if (!dc_res) {
+      std::cerr << "DataChannel creation failed\n";
+      co_return;
+    }
+    pcs.push_back(pc_res.value());
+    channels.push_back(dc_res.value());
+  }
+
+  std::vector<double> offer_us;
+  offer_us.reserve(pcs.size());
+  auto start = bench::Clock::now();
+  for (auto& pc : pcs) {
+    auto offer_start = bench::Clock::now();
+    auto offer = co_await pc->create_offer();
+    if (!offer) {
+      std::cerr << "Offer failed\n";
+      co_return;
+    }
+    offer_us.push_back(bench::elapsed_ms(offer_start) * 1000.0);
+  }
+  double total_ms = bench::elapsed_ms(start);
+
+  results.push_back(bench::JsonObject()
+                        .add("templates", templates)
+                        .add("connections", static_cast<std::uint64_t>(connections))
+                        .add("offers_per_sec", connections / (total_ms / 1000.0))
+                        .add("offer_us", bench::summarize(std::move(offer_us)))
+                        .str());
+
+  channels.clear();
+  for (auto& pc : pcs) {
+    pc->close();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int connections = argc > 1 ? std::stoi(argv[1]) : 200;
+
+  auto context_res = RtcContext::Create({.profile = FactoryProfile::DataOnly});
+  if (!context_res) {
+    std::cerr << "Context creation failed: " << context_res.error().message() << "\n";
+    return 1;
+  }
+
+  std::vector<std::string> results;
+  for (bool templates : {false, true}) {
+    asio::io_context ctx;
+    asio::co_spawn(ctx, measure(context_res.value(), templates, connections, results),
+                   asio::detached);
+    ctx.run();
+  }
+  std::cout << bench::json_array(results) << std::endl;
+  return 0;
+}
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <librtc/data_channel.hpp>
 #include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -25,8 +26,8 @@ struct Peer : std::enable_shared_from_this<Peer> {
 
   Peer(std::string n) : name(std::move(n)) {}
 
-  asio::awaitable<void> initialize() {
-    auto pc_res = PeerConnection::Create();
+  asio::awaitable<void> initialize(std::shared_ptr<RtcContext> context) {
+    auto pc_res = PeerConnection::Create(std::move(context));
     if (!pc_res) {
       co_return;
     }
@@ -34,7 +35,9 @@ struct Peer : std::enable_shared_from_this<Peer> {
 
     auto self = weak_from_this();
 
-    pc->on_ice_candidate(self, [](auto& p, const IceCandidate& c) { p.pending_ice.push_back(c); });
+    pc->on_ice_candidates(self, [](auto& p, const IceCandidateBatch& batch) {
+      p.pending_ice.insert(p.pending_ice.end(), batch.candidates.begin(), batch.candidates.end());
+    });
 
     pc->on_ice_connection_state_change(self, [](auto& p, IceConnectionState state) {
       std::cout << "[" << p.name << "] ICE: " << (int)state << "\n";
@@ -80,11 +83,18 @@ struct Peer : std::enable_shared_from_this<Peer> {
 asio::awaitable<void> run_test() {
   auto executor = co_await asio::this_coro::executor;
 
+  // Both peers share one set of WebRTC threads and one factory.
+  auto context_res = RtcContext::Create();
+  if (!context_res) {
+    std::cerr << "Context creation failed\n";
+    co_return;
+  }
+
   auto alice = std::make_shared<Peer>("Alice");
   auto bob = std::make_shared<Peer>("Bob");
 
-  co_await alice->initialize();
-  co_await bob->initialize();
+  co_await alice->initialize(context_res.value());
+  co_await bob->initialize(context_res.value());
 
   // Alice creates data channel
   auto dc_res = alice->pc->create_data_channel("test");
@@ -92,8 +102,9 @@ asio::awaitable<void> run_test() {
     alice->setup_dc(dc_res.value());
   }
 
-  // SDP Exchange
-  auto offer_res = co_await alice->pc->create_offer();
+  // SDP Exchange. offer_and_set_local/answer_and_set_local create and apply the local
+  // description in one step.
+  auto offer_res = co_await alice->pc->offer_and_set_local();
   if (!offer_res) {
     std::cerr << "Offer failed\n";
     alice->stop();
@@ -101,10 +112,9 @@ asio::awaitable<void> run_test() {
     co_return;
   }
 
-  (void)co_await alice->pc->set_local_description(offer_res.value());
-  (void)co_await bob->pc->set_remote_description(offer_res.value());
+  (void)co_await bob->pc->set_remote_description(std::move(offer_res).value());
 
-  auto answer_res = co_await bob->pc->create_answer();
+  auto answer_res = co_await bob->pc->answer_and_set_local();
   if (!answer_res) {
     std::cerr << "Answer failed\n";
     alice->stop();
@@ -112,16 +122,15 @@ asio::awaitable<void> run_test() {
     co_return;
   }
 
-  (void)co_await bob->pc->set_local_description(answer_res.value());
-  (void)co_await alice->pc->set_remote_description(answer_res.value());
+  (void)co_await alice->pc->set_remote_description(std::move(answer_res).value());
 
   // ICE Exchange
   asio::steady_timer timer(executor);
   for (int i = 0; i < 5; ++i) {
     timer.expires_after(100ms);
     co_await timer.async_wait(asio::use_awaitable);
-    for (const auto& c : alice->pending_ice) (void)bob->pc->add_ice_candidate(c);
-    for (const auto& c : bob->pending_ice) (void)alice->pc->add_ice_candidate(c);
+    (void)co_await bob->pc->add_ice_candidates(alice->pending_ice);
+    (void)co_await alice->pc->add_ice_candidates(bob->pending_ice);
     alice->pending_ice.clear();
     bob->pending_ice.clear();
   }
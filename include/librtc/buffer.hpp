@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+
+namespace librtc {
+
+namespace detail {
+struct BufferAccess;
+}  // namespace detail
+
+/**
+ * Buffer is a ref-counted, copy-on-write byte buffer backed by WebRTC's CopyOnWriteBuffer.
+ *
+ * Copying a Buffer only bumps a reference count; writing through mutable_data() detaches
+ * the buffer first if its storage is shared. Passing a Buffer to DataChannel::send hands
+ * the storage to SCTP without copying the payload, so one Buffer can be filled in place
+ * once and broadcast to any number of channels.
+ */
+class Buffer {
+ public:
+  Buffer();
+
+  // Allocates \p size bytes of uninitialized storage, ready to be filled via mutable_data().
+  explicit Buffer(std::size_t size);
+
+  // Allocates \p size bytes with room to grow to \p capacity without reallocating.
+  Buffer(std::size_t size, std::size_t capacity);
+
+  Buffer(const Buffer& other);
+  Buffer(Buffer&& other) noexcept;
+  Buffer& operator=(const Buffer& other);
+  Buffer& operator=(Buffer&& other) noexcept;
+  ~Buffer();
+
+  // Copies \p data into a new buffer.
+  static Buffer copy_of(std::span<const std::byte> data);
+
+  std::span<const std::byte> data() const;
+
+  // Writable view of the bytes. Detaches from other Buffers sharing the storage.
+  std::span<std::byte> mutable_data();
+
+  std::size_t size() const;
+  std::size_t capacity() const;
+  bool empty() const {
+    return size() == 0;
+  }
+
+  void resize(std::size_t size);
+  void reserve(std::size_t capacity);
+  void clear();
+
+ private:
+  friend struct detail::BufferAccess;
+
+  // The WebRTC buffer lives in place, so a Buffer costs no allocation of its own, but
+  // stays opaque here; only the library reaches it through detail::BufferAccess.
+  alignas(void*) std::byte storage_[4 * sizeof(void*)];
+};
+
+}  // namespace librtc
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <boost/asio/awaitable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <librtc/buffer.hpp>
+#include <librtc/event_delivery.hpp>
 #include <librtc/utils/event.hpp>
 #include <librtc/utils/expected.hpp>
 #include <memory>
@@ -13,6 +18,23 @@ namespace librtc {
 
 enum class DataChannelState { Connecting, Open, Closing, Closed };
 
+// What happens to a message that arrives while the receive queue is full. Messages are
+// handed over on the signaling thread, which every connection of the RtcContext shares,
+// so the queue never waits for the consumer; a sender that must not outrun it needs
+// flow control of its own.
+enum class ReceiveOverflowPolicy {
+  // Discard the oldest queued message to make room.
+  DropOldest,
+  // Discard the incoming message and close the queue: the queued messages are dropped,
+  // and pending and later receive() calls fail with ReceiveQueueOverflow.
+  Error
+};
+
+struct ReceiveQueueConfig {
+  std::size_t capacity = 1024;
+  ReceiveOverflowPolicy overflow_policy = ReceiveOverflowPolicy::Error;
+};
+
 struct DataChannelConfig {
   bool ordered = true;
   std::optional<int> max_retransmit_time_ms;
@@ -20,30 +42,86 @@ struct DataChannelConfig {
   std::string protocol;
   bool negotiated = false;
   std::optional<int> id;
+  // Backpressure thresholds for async_send (see DataChannel::set_buffered_amount_thresholds).
+  uint64_t buffered_amount_high_threshold = 1024 * 1024;
+  uint64_t buffered_amount_low_threshold = 256 * 1024;
+  // Enables the receive() queue before the channel can receive its first message.
+  std::optional<ReceiveQueueConfig> receive_queue;
+};
+
+/**
+ * A received message that owns its payload. The Buffer shares storage with the
+ * WebRTC DataBuffer it was received in, so keeping, queueing or forwarding a
+ * Message costs a reference count, not an allocation and a copy.
+ */
+struct Message {
+  Buffer data;
+  bool is_binary = true;
 };
 
 class DataChannel {
  public:
   using MessageBuffer = std::span<const std::byte>;
+  template <typename T>
+  using Task = boost::asio::awaitable<Expected<T>>;
 
   virtual ~DataChannel() = default;
 
   // Event handlers
+  // The span is only valid during the callback; copy it or use on_owned_message.
   EVENT(message, MessageBuffer, bool)
+  EVENT(owned_message, const Message&)
   EVENT(state_change, DataChannelState)
+  // Fired when buffered_amount() drops from above the low threshold to or below it.
+  EVENT(buffered_amount_low)
 
   // Actions
   virtual Expected<void> send(MessageBuffer data, bool is_binary) = 0;
   virtual Expected<void> send(std::string_view text) = 0;
   virtual Expected<void> send(const std::vector<std::byte>& data) = 0;
 
+  // Zero-copy sends: the Buffer's storage is shared with SCTP, not copied. The const
+  // overload leaves the caller's Buffer intact so it can be sent to other channels.
+  virtual Expected<void> send(const Buffer& data, bool is_binary = true) = 0;
+  virtual Expected<void> send(Buffer&& data, bool is_binary = true) = 0;
+
+  /**
+   * Sends with backpressure: suspends while buffered_amount() is above the high
+   * threshold and resumes on the executor once it has drained to the low threshold.
+   * Completes with DataChannelError::Closed if the channel closes while waiting.
+   */
+  virtual Task<void> async_send(Buffer data, bool is_binary = true) = 0;
+
+  // Thresholds used by async_send and on_buffered_amount_low, in bytes.
+  virtual void set_buffered_amount_thresholds(uint64_t high, uint64_t low) = 0;
+
+  /**
+   * Pull-style receiving through a bounded queue between the WebRTC thread and the
+   * executor. Messages are queued from the moment the queue is enabled, either
+   * explicitly or by the first receive() call; events keep firing either way.
+   */
+  virtual void enable_receive_queue(const ReceiveQueueConfig& config = {}) = 0;
+
+  // Waits for the next message. Fails with Closed once the channel has closed and
+  // the queue is drained, or with ReceiveQueueOverflow once the queue has overflowed
+  // under ReceiveOverflowPolicy::Error.
+  virtual Task<Message> receive() = 0;
+
+  // Waits for at least one message and returns up to max_messages queued ones.
+  virtual Task<std::vector<Message>> receive_batch(std::size_t max_messages) = 0;
+
   virtual void close() = 0;
 
-  // Properties
+  // Properties. Cached from WebRTC's callbacks: safe to poll from any thread, never
+  // blocking on the WebRTC threads. buffered_amount() counts local sends at once and
+  // is corrected to WebRTC's value whenever it reports bytes sent.
   virtual std::string label() const = 0;
   virtual int id() const = 0;
   virtual uint64_t buffered_amount() const = 0;
   virtual DataChannelState state() const = 0;
+
+  // Counters of EventDelivery::Executor (inherited from the PeerConnection's config).
+  virtual DeliveryStats delivery_stats() const = 0;
 };
 
 }  // namespace librtc
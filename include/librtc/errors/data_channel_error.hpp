@@ -12,7 +12,9 @@ enum class DataChannelError {
   BufferFull,
   InvalidArgument,
   InvalidData,
-  Closed
+  Closed,
+  ReceiveQueueOverflow,
+  OperationCanceled
 };
 
 struct DataChannelErrorCategory : std::error_category {
@@ -33,6 +35,10 @@ struct DataChannelErrorCategory : std::error_category {
         return "Invalid argument";
       case DataChannelError::InvalidData:
         return "Invalid data";
+      case DataChannelError::ReceiveQueueOverflow:
+        return "Receive queue overflowed";
+      case DataChannelError::OperationCanceled:
+        return "Operation canceled";
     }
 
     return "Unknown error";
@@ -20,7 +20,8 @@ enum class PeerConnectionError {
   InvalidModification,
   NetworkError,
   ResourceExhausted,
-  OperationError
+  OperationError,
+  Timeout
 };
 
 struct PeerConnectionErrorCategory : std::error_category {
@@ -57,6 +58,8 @@ struct PeerConnectionErrorCategory : std::error_category {
         return "Resource exhausted";
       case PeerConnectionError::OperationError:
         return "Operation error";
+      case PeerConnectionError::Timeout:
+        return "Operation timed out";
     }
     return "Unknown error";
   }
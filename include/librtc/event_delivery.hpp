@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace librtc {
+
+enum class EventDelivery {
+  // Handlers run on the WebRTC thread that raised the event.
+  Direct,
+  // Events are queued on a lock-free ring and handlers run on the connection's
+  // executor. At most one drain task is posted per batch, instead of one post per event.
+  Executor
+};
+
+struct EventDeliveryConfig {
+  EventDelivery mode = EventDelivery::Direct;
+  // Ring capacity per PeerConnection and per DataChannel, rounded up to a power of two.
+  // Events that do not fit are kept in an overflow list, in order.
+  std::size_t queue_capacity = 1024;
+  // Maximum number of handlers run by one drain task before it yields the executor.
+  std::size_t max_batch = 256;
+};
+
+/**
+ * Counters of the Executor delivery mode, for tuning queue_capacity and max_batch.
+ * All values are zero in Direct mode.
+ */
+struct DeliveryStats {
+  // Drain tasks that ran, and events they delivered.
+  std::uint64_t batches = 0;
+  std::uint64_t events = 0;
+  std::uint64_t max_batch_size = 0;
+  // Events waiting for the executor right now, and the highest value seen.
+  std::size_t queue_depth = 0;
+  std::size_t max_queue_depth = 0;
+  // Events that found the ring full and went to the overflow list.
+  std::uint64_t overflowed = 0;
+};
+
+}  // namespace librtc
@@ -2,11 +2,16 @@
 
 #include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/awaitable.hpp>
+#include <chrono>
+#include <cstdint>
 #include <librtc/data_channel.hpp>
+#include <librtc/event_delivery.hpp>
+#include <librtc/rtc_context.hpp>
 #include <librtc/utils/event.hpp>
 #include <librtc/utils/expected.hpp>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -31,8 +36,53 @@ struct IceServer {
   std::string credential;
 };
 
+// Which local candidates are gathered and offered.
+enum class IceCandidateFilter {
+  All,
+  HostOnly,   // No STUN or TURN: fastest setup on networks where peers reach each other.
+  NoHost,     // Hides local addresses.
+  RelayOnly,  // TURN only.
+};
+
+// ICE and port allocator tuning. Unset intervals keep WebRTC's defaults.
+struct IceTransportConfig {
+  // Candidates gathered in advance, before the first local description is applied.
+  int candidate_pool_size = 0;
+  IceCandidateFilter candidate_filter = IceCandidateFilter::All;
+  bool tcp_candidates = true;
+  // Keep gathering as networks change instead of stopping after the first round.
+  bool continual_gathering = false;
+  // Local port range for host and relay sockets; 0 and 0 leave it to the OS.
+  std::uint16_t min_port = 0;
+  std::uint16_t max_port = 0;
+  std::optional<std::chrono::milliseconds> check_interval_strong_connectivity;
+  std::optional<std::chrono::milliseconds> check_interval_weak_connectivity;
+  std::optional<std::chrono::milliseconds> check_min_interval;
+  std::optional<std::chrono::milliseconds> unwritable_timeout;
+  std::optional<std::chrono::milliseconds> receiving_timeout;
+};
+
 struct PeerConnectionConfig {
   std::vector<IceServer> ice_servers;
+  IceTransportConfig ice;
+  // Where event handlers of this connection and its data channels run. Executor
+  // delivery requires an executor to be passed to PeerConnection::Create.
+  EventDeliveryConfig event_delivery;
+  // Upper bound for every create_offer, create_answer, set_local_description,
+  // set_remote_description and add_ice_candidates of this connection. An operation that
+  // does not finish in time completes with PeerConnectionError::Timeout; WebRTC's late
+  // callback is dropped. To bound a single operation, wrap it in with_timeout
+  // (utils/deadline.hpp). The operations also honour asio cancellation slots and then
+  // complete with OperationCanceled.
+  std::optional<std::chrono::milliseconds> operation_timeout;
+  // Reuse the initial offer/answer of an earlier connection of the same context with
+  // the same shape, patching only its ICE credentials and session id, instead of
+  // running CreateOffer/CreateAnswer. Such connections share one certificate per
+  // context, so their fingerprints are identical. Renegotiation is not affected.
+  bool description_templates = false;
+  // How long on_ice_candidates collects gathered candidates before delivering them as
+  // one batch. Zero delivers every candidate in its own batch right away.
+  std::chrono::milliseconds ice_candidate_batch_window{0};
 };
 
 struct SessionDescription {
@@ -40,12 +90,31 @@ struct SessionDescription {
   std::string sdp;
 };
 
+// A serialized description shared by all readers. generation starts at 1 and grows
+// every time the description is set or changes (for example gains a candidate), so
+// signaling code can skip resending a description it has already sent.
+struct SharedSessionDescription {
+  std::shared_ptr<const SessionDescription> description;  // Null while none is set.
+  std::uint64_t generation = 0;
+
+  explicit operator bool() const {
+    return description != nullptr;
+  }
+};
+
 struct IceCandidate {
   std::string candidate;
   std::string sdp_mid;
   int sdp_mline_index;
 };
 
+// Candidates gathered within one batch window. The last batch of a gathering round has
+// end_of_candidates set and may be empty.
+struct IceCandidateBatch {
+  std::vector<IceCandidate> candidates;
+  bool end_of_candidates = false;
+};
+
 class PeerConnection {
  public:
   template <typename T>
@@ -53,26 +122,59 @@ class PeerConnection {
 
   virtual ~PeerConnection() = default;
 
+  /**
+   * Creates a PeerConnection on the threads and factory owned by \p context.
+   * The connection keeps the context alive for as long as it exists.
+   */
   static Expected<std::shared_ptr<PeerConnection>> Create(
+      std::shared_ptr<RtcContext> context,
       std::optional<boost::asio::any_io_executor> executor = std::nullopt,
       const PeerConnectionConfig& config = {});
 
   // Event handlers
   EVENT(ice_candidate, const IceCandidate&)
+  EVENT(ice_candidates, const IceCandidateBatch&)
   EVENT(data_channel, std::shared_ptr<DataChannel>)
   EVENT(ice_connection_state_change, IceConnectionState)
   EVENT(signaling_state_change, SignalingState)
+  EVENT(ice_gathering_state_change, IceGatheringState)
 
   // Actions
   virtual Task<SessionDescription> create_offer() = 0;
   virtual Task<SessionDescription> create_answer() = 0;
   virtual Task<void> set_local_description(const SessionDescription& sdp) = 0;
   virtual Task<void> set_remote_description(const SessionDescription& sdp) = 0;
-
+  // Move the description into the returned task, which then stays valid on its own
+  // and can be awaited after the caller's object is gone.
+  virtual Task<void> set_local_description(SessionDescription&& sdp) = 0;
+  virtual Task<void> set_remote_description(SessionDescription&& sdp) = 0;
+
+  // Create an offer or answer and apply it as the local description in a single trip
+  // to the signaling thread, without parsing the SDP back. Returns the description.
+  virtual Task<SessionDescription> offer_and_set_local() = 0;
+  virtual Task<SessionDescription> answer_and_set_local() = 0;
+
+  // Getters read state cached from WebRTC's callbacks and never block on the
+  // WebRTC threads.
   virtual std::optional<SessionDescription> local_description() const = 0;
   virtual std::optional<SessionDescription> remote_description() const = 0;
+  // Same as above without copying the SDP.
+  virtual SharedSessionDescription shared_local_description() const = 0;
+  virtual SharedSessionDescription shared_remote_description() const = 0;
 
   virtual Expected<void> add_ice_candidate(const IceCandidate& candidate) = 0;
+  // Applies all candidates in a single trip to the signaling thread. Candidates are
+  // queued behind pending negotiation like in the WebRTC API, and empty candidates
+  // (end-of-candidates markers) are skipped. \p candidates must stay valid until the
+  // task is awaited.
+  virtual Task<void> add_ice_candidates(std::span<const IceCandidate> candidates) = 0;
+
+  // Waits until ICE gathering is complete and returns the local description with all
+  // candidates, for signaling that sends one description instead of trickling. When
+  // the timeout expires, returns the candidates gathered so far; a cancelled wait fails
+  // with OperationCanceled. Fails with InvalidState before a local description is set.
+  virtual Task<SessionDescription> wait_ice_gathering_complete(
+      std::optional<std::chrono::milliseconds> timeout = std::nullopt) = 0;
   virtual Expected<std::shared_ptr<DataChannel>> create_data_channel(
       const std::string& label, const DataChannelConfig& config = {}) = 0;
 
@@ -80,6 +182,9 @@ class PeerConnection {
   virtual IceConnectionState ice_connection_state() const = 0;
   virtual IceGatheringState ice_gathering_state() const = 0;
 
+  // Counters of EventDelivery::Executor for this connection's own events.
+  virtual DeliveryStats delivery_stats() const = 0;
+
   virtual void close() = 0;
 };
 
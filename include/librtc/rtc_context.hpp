@@ -0,0 +1,92 @@
+#pragma once
+
+#include <librtc/utils/expected.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace librtc {
+
+enum class FactoryProfile {
+  // Audio/video codec factories are registered, as needed for media tracks.
+  Full,
+  // Data channels only: no codec factories and no audio device module, which cuts
+  // startup time and resident memory on headless servers.
+  DataOnly
+};
+
+// Options applied to every UDP and TCP socket the network threads create for ICE.
+struct SocketOptions {
+  // SO_RCVBUF / SO_SNDBUF in bytes. The kernel may clamp (and on Linux doubles) the
+  // requested size; RtcContext::socket_stats() reports the size actually in effect.
+  std::optional<int> receive_buffer_size;
+  std::optional<int> send_buffer_size;
+  // DiffServ code point (0-63) for outgoing packets, for example 46 (EF) for
+  // latency-critical sessions.
+  std::optional<int> dscp;
+};
+
+// Socket options as applied by the network threads.
+struct SocketStats {
+  // Sockets created with options applied, and SetOption calls the OS rejected.
+  std::size_t sockets = 0;
+  std::size_t failures = 0;
+  // Read back from the most recently created socket; unset until one exists or when
+  // the option is not configured.
+  std::optional<int> receive_buffer_size;
+  std::optional<int> send_buffer_size;
+  std::optional<int> dscp;
+};
+
+struct RtcContextConfig {
+  FactoryProfile profile = FactoryProfile::Full;
+  // Number of network/worker thread pairs ("shards"). Every shard has its own
+  // PeerConnectionFactory, and new PeerConnections are placed on the least-loaded one.
+  // 0 (the default) creates one shard per CPU the process may run on.
+  std::size_t shard_count = 0;
+  // Pin the threads of shard i to the i-th CPU of the process affinity mask (wrapping
+  // around). Only honored on Linux; ShardLoad::cpu reports pins that took effect.
+  bool pin_shards = false;
+  // Threads are named "<prefix>-net-<i>", "<prefix>-worker-<i>" and "<prefix>-signaling".
+  std::string thread_name_prefix = "librtc";
+  SocketOptions socket_options;
+};
+
+struct ShardLoad {
+  std::size_t index;
+  std::size_t peer_connections;
+  // CPU the shard's threads are pinned to; unset when not pinned or pinning failed.
+  std::optional<int> cpu;
+};
+
+/**
+ * RtcContext owns the WebRTC network, worker and signaling threads together with
+ * the PeerConnectionFactory built on top of them. Every PeerConnection created from
+ * the same context shares these resources, so the number of threads stays constant
+ * no matter how many sessions are open.
+ *
+ * The context is kept alive by every PeerConnection (and DataChannel) created from it,
+ * so it is safe to drop the application's reference at any time.
+ */
+class RtcContext {
+ public:
+  virtual ~RtcContext() = default;
+
+  static Expected<std::shared_ptr<RtcContext>> Create(const RtcContextConfig& config = {});
+
+  // Number of PeerConnections currently attached to this context.
+  virtual std::size_t peer_connection_count() const = 0;
+
+  // Number of network/worker thread pairs.
+  virtual std::size_t shard_count() const = 0;
+
+  // Current PeerConnection count per shard, to spot placement imbalance.
+  virtual std::vector<ShardLoad> shard_loads() const = 0;
+
+  // Effective socket buffer sizes and DSCP from RtcContextConfig::socket_options.
+  virtual SocketStats socket_stats() const = 0;
+};
+
+}  // namespace librtc
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace librtc {
+
+/**
+ * One line of an SDP description, `<type>=<value>`, without its line terminator.
+ * A line that does not have that shape has type '\0'.
+ */
+struct SdpLine {
+  char type = '\0';
+  std::string_view value{};
+  std::string_view text{};
+
+  bool is_attribute() const {
+    return type == 'a';
+  }
+
+  // For `a=<name>[:<value>]` lines: the name and the value after ':' (empty if none).
+  std::string_view attribute_name() const;
+  std::string_view attribute_value() const;
+};
+
+/**
+ * Forward range over the lines of an SDP fragment. Iterating does not allocate.
+ */
+class SdpLines {
+ public:
+  class iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = SdpLine;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const SdpLine*;
+    using reference = const SdpLine&;
+
+    iterator() = default;
+    explicit iterator(std::string_view rest) : rest_(rest) {
+      advance();
+    }
+
+    reference operator*() const {
+      return line_;
+    }
+    pointer operator->() const {
+      return &line_;
+    }
+    iterator& operator++() {
+      advance();
+      return *this;
+    }
+    iterator operator++(int) {
+      auto copy = *this;
+      advance();
+      return copy;
+    }
+    bool operator==(const iterator& other) const {
+      return done_ == other.done_ && (done_ || line_.text.data() == other.line_.text.data());
+    }
+
+   private:
+    void advance();
+
+    std::string_view rest_;
+    SdpLine line_;
+    bool done_ = true;
+  };
+
+  explicit SdpLines(std::string_view text) : text_(text) {}
+
+  iterator begin() const {
+    return iterator(text_);
+  }
+  iterator end() const {
+    return iterator();
+  }
+
+ private:
+  std::string_view text_;
+};
+
+/**
+ * The session section of a description (everything before the first `m=` line) or
+ * one media section (an `m=` line and the lines up to the next one).
+ */
+class SdpSection {
+ public:
+  SdpSection() = default;
+  explicit SdpSection(std::string_view text) : text_(text) {}
+
+  std::string_view text() const {
+    return text_;
+  }
+  SdpLines lines() const {
+    return SdpLines(text_);
+  }
+
+  // Media type of a media section ("application", "audio", ...); empty for the
+  // session section.
+  std::string_view media() const;
+
+  // Value of the first `a=<name>` attribute, or nullopt if the section has none.
+  std::optional<std::string_view> attribute(std::string_view name) const;
+  bool has_attribute(std::string_view name) const {
+    return attribute(name).has_value();
+  }
+
+ private:
+  std::string_view text_;
+};
+
+/**
+ * Read-only structured view of a serialized description. The view parses lazily into
+ * string_views of \p sdp, which must outlive it, and never allocates.
+ *
+ *   librtc::SdpView view(offer.sdp);
+ *   auto fingerprint = view.fingerprint();
+ *   for (const auto& media : view.media_sections()) { ... }
+ */
+class SdpView {
+ public:
+  // Forward range over the media sections.
+  class MediaSections {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = SdpSection;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const SdpSection*;
+      using reference = const SdpSection&;
+
+      iterator() = default;
+      explicit iterator(std::string_view rest) : rest_(rest) {
+        advance();
+      }
+
+      reference operator*() const {
+        return section_;
+      }
+      pointer operator->() const {
+        return &section_;
+      }
+      iterator& operator++() {
+        advance();
+        return *this;
+      }
+      iterator operator++(int) {
+        auto copy = *this;
+        advance();
+        return copy;
+      }
+      bool operator==(const iterator& other) const {
+        return section_.text().data() == other.section_.text().data();
+      }
+
+     private:
+      void advance();
+
+      std::string_view rest_;
+      SdpSection section_;
+    };
+
+    explicit MediaSections(std::string_view text) : text_(text) {}
+
+    iterator begin() const {
+      return iterator(text_);
+    }
+    iterator end() const {
+      return iterator();
+    }
+
+   private:
+    std::string_view text_;
+  };
+
+  explicit SdpView(std::string_view sdp);
+
+  std::string_view text() const {
+    return sdp_;
+  }
+  SdpLines lines() const {
+    return SdpLines(sdp_);
+  }
+  SdpSection session() const {
+    return SdpSection(sdp_.substr(0, media_start_));
+  }
+  MediaSections media_sections() const {
+    return MediaSections(sdp_.substr(media_start_));
+  }
+  std::size_t media_count() const;
+
+  // True if the description starts with `v=` and every line is `<type>=<value>`.
+  bool well_formed() const;
+
+  // Value of the first `a=<name>` attribute, looking at the session section first and
+  // then at the media sections in order, since attributes like ice-ufrag may appear
+  // at either level.
+  std::optional<std::string_view> attribute(std::string_view name) const;
+  bool has_attribute(std::string_view name) const {
+    return attribute(name).has_value();
+  }
+
+  // <sess-id> of the `o=` line.
+  std::optional<std::string_view> session_id() const;
+  std::optional<std::string_view> ice_ufrag() const {
+    return attribute("ice-ufrag");
+  }
+  std::optional<std::string_view> ice_pwd() const {
+    return attribute("ice-pwd");
+  }
+  // "<hash> <fingerprint>", for example "sha-256 AB:CD:...".
+  std::optional<std::string_view> fingerprint() const {
+    return attribute("fingerprint");
+  }
+  std::optional<int> sctp_port() const;
+
+ private:
+  std::string_view sdp_;
+  std::size_t media_start_;
+};
+
+/**
+ * Builds a modified copy of a description in a single pass. Edits are recorded first
+ * and applied by build(), which walks the source once and writes every line at most
+ * once into the output:
+ *
+ *   auto sdp = librtc::SdpEditor(offer.sdp)
+ *                  .remove_attribute("candidate")
+ *                  .set_attribute("max-message-size", "65536")
+ *                  .build();
+ *
+ * The source must outlive the editor. Attribute edits apply to every matching line in
+ * every section, and edits are applied in the order they were added.
+ */
+class SdpEditor {
+ public:
+  using AttributeTransform = std::function<std::string(std::string_view value)>;
+
+  explicit SdpEditor(std::string_view sdp) : sdp_(sdp) {}
+
+  // Replaces the value of every `a=<name>` line.
+  SdpEditor& set_attribute(std::string_view name, std::string value);
+  // Replaces the value of every `a=<name>` line with transform(old value).
+  SdpEditor& transform_attribute(std::string_view name, AttributeTransform transform);
+  // Drops every `a=<name>` line.
+  SdpEditor& remove_attribute(std::string_view name);
+  // Appends `a=<name>[:<value>]` to the session section, or to the media section at
+  // \p media_index (counting from 0).
+  SdpEditor& add_session_attribute(std::string_view name, std::string_view value = {});
+  SdpEditor& add_media_attribute(std::size_t media_index, std::string_view name,
+                                 std::string_view value = {});
+  // Replaces <sess-id> of the `o=` line.
+  SdpEditor& set_session_id(std::string session_id);
+
+  std::string build() const;
+  // Same as build(), reusing the capacity of \p out.
+  void build_into(std::string& out) const;
+
+ private:
+  struct AttributeEdit {
+    std::string name;
+    std::optional<std::string> value{};  // Removes the line when unset and no transform.
+    AttributeTransform transform{};
+  };
+  struct AddedAttribute {
+    std::optional<std::size_t> media_index;  // Session section when unset.
+    std::string line;
+  };
+
+  SdpEditor& add_attribute_line(std::optional<std::size_t> media_index, std::string_view name,
+                                std::string_view value);
+  void append_added(std::string& out, std::optional<std::size_t> media_index) const;
+
+  std::string_view sdp_;
+  std::vector<AttributeEdit> edits_;
+  std::vector<AddedAttribute> added_;
+  std::optional<std::string> session_id_;
+};
+
+}  // namespace librtc
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <boost/asio/awaitable.hpp>
+#include <chrono>
+#include <cstdint>
+#include <librtc/data_channel.hpp>
+#include <librtc/peer_connection.hpp>
+#include <librtc/rtc_context.hpp>
+#include <librtc/utils/expected.hpp>
+#include <memory>
+#include <string>
+
+namespace librtc::testing {
+
+// Link conditions of the in-process virtual network, applied to every packet.
+struct LoopbackNetworkConfig {
+  std::chrono::milliseconds latency{0};
+  // Standard deviation of the latency.
+  std::chrono::milliseconds jitter{0};
+  // Per-socket send rate; 0 is unlimited.
+  std::uint32_t bandwidth_bytes_per_sec = 0;
+  // Probability (0 to 1) that a UDP packet is dropped.
+  double loss = 0;
+};
+
+struct LoopbackPairConfig {
+  // Used for both peers.
+  PeerConnectionConfig peer;
+  std::string channel_label = "loopback";
+  DataChannelConfig channel;
+  // Upper bound for negotiation, ICE and the channel opening on both sides. Fails with
+  // PeerConnectionError::Timeout when exceeded.
+  std::chrono::milliseconds timeout{10000};
+};
+
+// Two connected peers and the open data channel between them. The offerer created the
+// channel; the answerer received it through on_data_channel.
+struct LoopbackPair {
+  std::shared_ptr<RtcContext> context;
+  std::shared_ptr<PeerConnection> offerer;
+  std::shared_ptr<PeerConnection> answerer;
+  std::shared_ptr<DataChannel> offerer_channel;
+  std::shared_ptr<DataChannel> answerer_channel;
+  // Measured from the start of make_loopback_pair: both PeerConnections created, ICE
+  // connected on both sides, channel open on both sides. The last two are taken in the
+  // ice_connection_state_change and state_change handlers, so they include event
+  // delivery but no polling delay.
+  std::chrono::nanoseconds create_time{0};
+  std::chrono::nanoseconds connect_time{0};
+  std::chrono::nanoseconds open_time{0};
+};
+
+/**
+ * Creates a context whose network threads run on WebRTC's VirtualSocketServer instead
+ * of OS sockets. Connections of this context reach each other through an in-memory
+ * network with the given conditions, and never reach anything else. The context always
+ * has a single shard, since peers can only meet on the same virtual network;
+ * config.shard_count is ignored.
+ */
+Expected<std::shared_ptr<RtcContext>> make_loopback_context(
+    const LoopbackNetworkConfig& network = {}, RtcContextConfig config = {});
+
+/**
+ * Creates two peers on \p context, negotiates them with in-memory signaling (offer,
+ * answer and candidate batches passed directly between them) and completes once the
+ * data channel is open on both sides. Works with any context: one from
+ * make_loopback_context for a simulated network, or a regular one for the host's
+ * interfaces.
+ *
+ *   auto pair = co_await librtc::testing::make_loopback_pair(
+ *       librtc::testing::make_loopback_context({.latency = 20ms}).value());
+ *   pair.value().offerer_channel->send(...);
+ */
+boost::asio::awaitable<Expected<LoopbackPair>> make_loopback_pair(
+    std::shared_ptr<RtcContext> context, LoopbackPairConfig config = {});
+
+// Same as above on a new DataOnly context from make_loopback_context(network).
+boost::asio::awaitable<Expected<LoopbackPair>> make_loopback_pair(
+    LoopbackNetworkConfig network = {}, LoopbackPairConfig config = {});
+
+}  // namespace librtc::testing
@@ -1,24 +1,117 @@
 #pragma once
 
 #include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/associated_allocator.hpp>
 #include <boost/asio/associated_executor.hpp>
+#include <boost/asio/associated_cancellation_slot.hpp>
 #include <boost/asio/async_result.hpp>
+#include <boost/asio/cancellation_type.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/asio/use_awaitable.hpp>
 #include <librtc/utils/expected.hpp>
+#include <librtc/utils/recycling_allocator.hpp>
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <system_error>
+#include <type_traits>
+#include <utility>
 
 namespace librtc {
 
+/**
+ * Error a bridged operation completes with when it is canceled before WebRTC
+ * reports back. Specialize for error types without an OperationCanceled value.
+ */
+template <typename E>
+struct OperationCanceledError {
+  static E value() {
+    return E::OperationCanceled;
+  }
+};
+
+template <>
+struct OperationCanceledError<std::error_code> {
+  static std::error_code value() {
+    return std::make_error_code(std::errc::operation_canceled);
+  }
+};
+
 /**
  * A stable, production-ready utility to bridge WebRTC callbacks to Asio's
  * universal asynchronous model (including coroutines).
+ *
+ * The operation state (handler, executor and result) is allocated once with the
+ * handler's associated allocator, falling back to the per-thread RecyclingAllocator,
+ * and the same allocator backs the task that carries the result to the executor.
+ * In steady state a bridged operation therefore does not reach malloc.
+ *
+ * Operations honour the handler's cancellation slot: terminal cancellation (for
+ * example from `co_await (op || timer)`) completes the handler immediately with
+ * OperationCanceledError<E>, and the WebRTC callback that arrives later is dropped.
+ * A Completion destroyed without being called completes the same way.
  */
 template <typename T, typename E = std::error_code>
 class AsyncBridge {
+  class OpBase;
+
  public:
+  /**
+   * One-shot completion handed to the initiating function. Invoking it marshals the
+   * result to the executor; it may be called from any thread. It is move-only, so it
+   * can be stored in an observer without a std::function. Invoking it after the
+   * operation was canceled is a no-op.
+   */
+  class Completion {
+   public:
+    Completion() = default;
+
+    explicit Completion(OpBase* op) : op_(op) {}
+
+    Completion(Completion&& other) noexcept : op_(std::exchange(other.op_, nullptr)) {}
+
+    Completion& operator=(Completion&& other) noexcept {
+      if (this != &other) {
+        reset();
+        op_ = std::exchange(other.op_, nullptr);
+      }
+      return *this;
+    }
+
+    Completion(const Completion&) = delete;
+    Completion& operator=(const Completion&) = delete;
+
+    ~Completion() {
+      reset();
+    }
+
+    void operator()(Result<T, E> result) {
+      if (auto* op = std::exchange(op_, nullptr)) {
+        op->complete(std::move(result));
+      }
+    }
+
+    explicit operator bool() const {
+      return op_ != nullptr;
+    }
+
+    // True once the operation was canceled. Invoking the Completion would do nothing,
+    // so one kept in a list of waiters can be dropped.
+    bool canceled() const {
+      return op_ && op_->resolved();
+    }
+
+   private:
+    void reset() {
+      if (auto* op = std::exchange(op_, nullptr)) {
+        op->discard();
+      }
+    }
+
+    OpBase* op_ = nullptr;
+  };
+
   /**
    * Initiates the operation. This is the entry point for co_await.
    */
@@ -28,18 +121,7 @@ class AsyncBridge {
         [initiate_func = std::forward<Func>(initiate_func)](auto handler) mutable {
           // Get the executor associated with the handler (e.g., from use_awaitable)
           auto executor = boost::asio::get_associated_executor(handler);
-
-          // Wrap the handler in a shared pointer to allow it to be safely
-          // called from the WebRTC signaling thread.
-          auto shared_handler = std::make_shared<decltype(handler)>(std::move(handler));
-
-          auto callback = [shared_handler, executor](Result<T, E> res) mutable {
-            // Marshall the result back to the application thread/executor.
-            boost::asio::post(executor, [h = std::move(*shared_handler),
-                                         r = std::move(res)]() mutable { h(std::move(r)); });
-          };
-
-          initiate_func(std::move(callback));
+          initiate_func(start(std::move(handler), std::move(executor)));
         },
         token);
   }
@@ -53,15 +135,9 @@ class AsyncBridge {
     return boost::asio::async_initiate<CompletionToken, void(Result<T, E>)>(
         [initiate_func = std::forward<Func>(initiate_func), executor](auto handler) mutable {
           // If no executor was explicitly provided, try to get it from the handler.
-          auto exec = executor ? *executor : boost::asio::get_associated_executor(handler);
-
-          auto shared_handler = std::make_shared<decltype(handler)>(std::move(handler));
-          auto callback = [shared_handler, exec](Result<T, E> res) mutable {
-            boost::asio::post(exec, [h = std::move(*shared_handler), r = std::move(res)]() mutable {
-              h(std::move(r));
-            });
-          };
-          initiate_func(std::move(callback));
+          boost::asio::any_io_executor exec =
+              executor ? *executor : boost::asio::get_associated_executor(handler);
+          initiate_func(start(std::move(handler), std::move(exec)));
         },
         token);
   }
@@ -75,6 +151,163 @@ class AsyncBridge {
     return async_run(std::make_optional(executor), std::forward<Func>(initiate_func),
                      std::forward<CompletionToken>(token));
   }
+
+ private:
+  class OpBase {
+   public:
+    // Posts the handler with result unless the operation was already canceled, and
+    // drops the Completion's reference. Called at most once.
+    virtual void complete(Result<T, E> result) = 0;
+    // Completes as canceled and drops the Completion's reference.
+    virtual void discard() = 0;
+    virtual bool resolved() const = 0;
+
+   protected:
+    ~OpBase() = default;
+  };
+
+  template <typename Handler, typename Executor>
+  class Op final : public OpBase {
+   public:
+    using Allocator = typename std::allocator_traits<
+        boost::asio::associated_allocator_t<Handler, RecyclingAllocator<void>>>::
+        template rebind_alloc<Op>;
+
+    static Op* create(Handler handler, Executor executor) {
+      Allocator allocator(
+          boost::asio::get_associated_allocator(handler, RecyclingAllocator<void>()));
+      auto* op = std::allocator_traits<Allocator>::allocate(allocator, 1);
+      ::new (op) Op(std::move(handler), std::move(executor), allocator);
+      if (op->slot_.is_connected()) {
+        op->slot_.template emplace<CancelHandler>(op);
+      }
+      return op;
+    }
+
+    void complete(Result<T, E> result) override {
+      resolve(std::move(result));
+      release();
+    }
+
+    void discard() override {
+      complete(Err(OperationCanceledError<E>::value()));
+    }
+
+    bool resolved() const override {
+      return resolved_.load(std::memory_order_acquire);
+    }
+
+   private:
+    using Slot = boost::asio::associated_cancellation_slot_t<Handler>;
+
+    // Installed in the handler's cancellation slot; runs on the executor.
+    struct CancelHandler {
+      explicit CancelHandler(Op* op) : op(op) {}
+
+      void operator()(boost::asio::cancellation_type type) {
+        // WebRTC cannot undo an operation it has started, so only terminal
+        // cancellation, which allows side effects, is supported.
+        if ((type & boost::asio::cancellation_type::terminal) !=
+            boost::asio::cancellation_type::none) {
+          op->resolve(Err(OperationCanceledError<E>::value()));
+        }
+      }
+
+      Op* op;
+    };
+
+    // First caller wins; the result is posted to the executor exactly once.
+    void resolve(Result<T, E> result) {
+      if (resolved_.exchange(true, std::memory_order_acq_rel)) {
+        return;
+      }
+      result_.emplace(std::move(result));
+      // any_io_executor wraps posted work with std::allocator, which asio only
+      // recycles on its own threads. Posting to the concrete io_context executor
+      // lets asio allocate with Resume's allocator instead.
+      if constexpr (std::is_same_v<Executor, boost::asio::any_io_executor>) {
+        if (auto* io = executor_.template target<boost::asio::io_context::executor_type>()) {
+          auto executor = *io;
+          boost::asio::post(executor, Resume{this});
+          return;
+        }
+      }
+      auto executor = executor_;
+      boost::asio::post(executor, Resume{this});
+    }
+
+    // Task posted to the executor. It carries the op's allocator so that asio
+    // allocates its own wrapper from the same pool.
+    struct Resume {
+      using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<void>;
+
+      explicit Resume(Op* op) : op(op) {}
+      Resume(Resume&& other) noexcept : op(std::exchange(other.op, nullptr)) {}
+      Resume(const Resume&) = delete;
+
+      ~Resume() {
+        // Dropped unrun, e.g. by an executor that is shutting down.
+        if (op) {
+          op->release();
+        }
+      }
+
+      allocator_type get_allocator() const noexcept {
+        return allocator_type(op->allocator_);
+      }
+
+      void operator()() {
+        std::exchange(op, nullptr)->finish();
+      }
+
+      Op* op;
+    };
+
+    Op(Handler handler, Executor executor, const Allocator& allocator)
+        : handler_(std::move(handler)),
+          executor_(std::move(executor)),
+          allocator_(allocator),
+          slot_(boost::asio::get_associated_cancellation_slot(handler_)) {}
+
+    // Releases the op before running the handler, so memory is usually back in the
+    // pool by the time the handler starts the next operation.
+    void finish() {
+      if (slot_.is_connected()) {
+        slot_.clear();
+      }
+      auto handler = std::move(handler_);
+      auto result = std::move(*result_);
+      release();
+      std::move(handler)(std::move(result));
+    }
+
+    // One reference is held by the Completion and one by the handler side, so a
+    // late WebRTC callback after cancellation still finds the op alive.
+    void release() {
+      if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        destroy();
+      }
+    }
+
+    void destroy() {
+      Allocator allocator(allocator_);
+      this->~Op();
+      std::allocator_traits<Allocator>::deallocate(allocator, this, 1);
+    }
+
+    Handler handler_;
+    Executor executor_;
+    Allocator allocator_;
+    Slot slot_;
+    std::optional<Result<T, E>> result_;
+    std::atomic<bool> resolved_{false};
+    std::atomic<int> refs_{2};
+  };
+
+  template <typename Handler, typename Executor>
+  static Completion start(Handler handler, Executor executor) {
+    return Completion(Op<Handler, Executor>::create(std::move(handler), std::move(executor)));
+  }
 };
 
 }  // namespace librtc
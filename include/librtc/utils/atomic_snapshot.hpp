@@ -0,0 +1,229 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace librtc {
+
+namespace detail {
+
+/**
+ * Reader registry shared by every AtomicSnapshot (epoch-based reclamation).
+ *
+ * Readers register under the parity of a global epoch, on one of a few counters
+ * spread over separate cache lines, so readers on different threads rarely share a
+ * line. The epoch advances only once no reader of the previous epoch is left; a value
+ * retired at epoch E is therefore unreachable once the epoch has reached E + 2, even if
+ * readers never stop overlapping. Nothing here ever waits.
+ */
+class SnapshotEpochs {
+ public:
+  using Counter = std::atomic<std::size_t>;
+
+  // Never destroyed, so snapshots owned by static objects stay readable during exit.
+  static SnapshotEpochs& instance() {
+    static auto* epochs = new SnapshotEpochs();
+    return *epochs;
+  }
+
+  // Registers a reader and returns the counter to pass to leave().
+  Counter* enter() {
+    auto& stripe = stripes_[stripe_index()];
+    while (true) {
+      auto epoch = epoch_.load(std::memory_order_seq_cst);
+      auto* counter = &stripe.readers[epoch & 1];
+      counter->fetch_add(1, std::memory_order_seq_cst);
+      // Registering under a parity the epoch has already moved past would hide this
+      // reader from the check that allows the next advance.
+      if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+        return counter;
+      }
+      counter->fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+  static void leave(Counter* counter) {
+    counter->fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  std::uint64_t epoch() const {
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  // Advances the epoch as far as finished readers allow (at most twice) and returns
+  // it. Returns the current epoch right away if another thread is advancing it.
+  std::uint64_t try_advance() {
+    std::unique_lock lock(advance_mutex_, std::try_to_lock);
+    if (!lock) {
+      return epoch();
+    }
+    auto epoch = epoch_.load(std::memory_order_relaxed);
+    // Readers of epoch - 1 share the parity of epoch + 1.
+    for (int i = 0; i < 2 && quiescent((epoch + 1) & 1); ++i) {
+      epoch_.store(++epoch, std::memory_order_seq_cst);
+    }
+    return epoch;
+  }
+
+ private:
+  static constexpr std::size_t kStripes = 16;
+
+  struct alignas(64) Stripe {
+    std::array<Counter, 2> readers{};
+  };
+
+  SnapshotEpochs() = default;
+
+  static std::size_t stripe_index() {
+    static std::atomic<std::size_t> next{0};
+    thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+    return index;
+  }
+
+  bool quiescent(std::size_t parity) const {
+    return std::all_of(stripes_.begin(), stripes_.end(), [parity](const Stripe& stripe) {
+      return stripe.readers[parity].load(std::memory_order_seq_cst) == 0;
+    });
+  }
+
+  std::atomic<std::uint64_t> epoch_{0};
+  std::mutex advance_mutex_;
+  std::array<Stripe, kStripes> stripes_;
+};
+
+}  // namespace detail
+
+/**
+ * AtomicSnapshot publishes an immutable value that readers access without locking
+ * or allocating (read-copy-update).
+ *
+ * Writers are serialized by a mutex, build a new value and swap it in atomically.
+ * Replaced values are retired and freed once every reader that could still see them
+ * has finished (see detail::SnapshotEpochs), so a reader's view stays valid for as
+ * long as it holds its ReadGuard. Reclamation runs on writes and, when values are
+ * waiting, at the end of reads, so retired values do not outlive the readers that
+ * hold them by more than one further read or write. Reads are meant to be short: a
+ * guard held forever postpones reclamation in every snapshot.
+ */
+template <typename T>
+class AtomicSnapshot {
+ public:
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const AtomicSnapshot& owner)
+        : owner_(owner), counter_(detail::SnapshotEpochs::instance().enter()) {
+      value_ = owner_.current_.load(std::memory_order_seq_cst);
+    }
+
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
+
+    ~ReadGuard() {
+      detail::SnapshotEpochs::leave(counter_);
+      if (owner_.has_retired_.load(std::memory_order_seq_cst)) {
+        // Never wait for a writer: a busy one reclaims on its own. Freed values are
+        // destroyed after unlocking, and owner_ is not touched again, in case
+        // destroying one of them destroys the snapshot.
+        std::vector<Retired> freed;
+        std::unique_lock lock(owner_.write_mutex_, std::try_to_lock);
+        if (lock) {
+          freed = owner_.reclaim();
+        }
+      }
+    }
+
+    const T& operator*() const {
+      return *value_;
+    }
+
+    const T* operator->() const {
+      return value_;
+    }
+
+   private:
+    const AtomicSnapshot& owner_;
+    detail::SnapshotEpochs::Counter* counter_;
+    const T* value_;
+  };
+
+  AtomicSnapshot() : AtomicSnapshot(T{}) {}
+
+  explicit AtomicSnapshot(T value) : current_(new T(std::move(value))) {}
+
+  AtomicSnapshot(const AtomicSnapshot&) = delete;
+  AtomicSnapshot& operator=(const AtomicSnapshot&) = delete;
+
+  ~AtomicSnapshot() {
+    delete current_.load(std::memory_order_acquire);
+  }
+
+  ReadGuard read() const {
+    return ReadGuard(*this);
+  }
+
+  void store(T value) {
+    std::vector<Retired> freed;
+    std::lock_guard lock(write_mutex_);
+    freed = publish(std::move(value));
+  }
+
+  /**
+   * Replaces the value with \p fn(current). Concurrent updates are serialized, so
+   * \p fn always sees the latest value. \p fn must not read this snapshot.
+   */
+  template <typename F>
+  void update(F&& fn) {
+    std::vector<Retired> freed;
+    std::lock_guard lock(write_mutex_);
+    freed = publish(fn(static_cast<const T&>(*current_.load(std::memory_order_relaxed))));
+  }
+
+ private:
+  struct Retired {
+    std::unique_ptr<const T> value;
+    std::uint64_t epoch;
+  };
+
+  // Returns the values that became unreachable, to be destroyed without the lock.
+  std::vector<Retired> publish(T value) {
+    auto* previous = current_.exchange(new T(std::move(value)), std::memory_order_seq_cst);
+    // Readers that loaded previous registered no later than this epoch.
+    retired_.push_back({std::unique_ptr<const T>(previous),
+                        detail::SnapshotEpochs::instance().epoch()});
+    // Set before reclaim() checks the readers: one that finishes after the check
+    // sees the flag and retries.
+    has_retired_.store(true, std::memory_order_seq_cst);
+    return reclaim();
+  }
+
+  // Called with write_mutex_ held. Retired values are in epoch order.
+  std::vector<Retired> reclaim() const {
+    auto epoch = detail::SnapshotEpochs::instance().try_advance();
+    auto reachable = std::find_if(retired_.begin(), retired_.end(),
+                                  [epoch](const Retired& r) { return r.epoch + 2 > epoch; });
+    std::vector<Retired> freed;
+    if (reachable == retired_.end()) {
+      freed.swap(retired_);
+    } else {
+      freed.assign(std::make_move_iterator(retired_.begin()), std::make_move_iterator(reachable));
+      retired_.erase(retired_.begin(), reachable);
+    }
+    has_retired_.store(!retired_.empty(), std::memory_order_seq_cst);
+    return freed;
+  }
+
+  std::atomic<const T*> current_;
+  mutable std::mutex write_mutex_;
+  mutable std::vector<Retired> retired_;
+  mutable std::atomic<bool> has_retired_{false};
+};
+
+}  // namespace librtc
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/experimental/awaitable_operators.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <chrono>
+#include <librtc/utils/expected.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace librtc {
+
+/**
+ * Bounds a single operation: completes with \p timeout_error if \p operation has not
+ * finished within \p timeout. The operation is cancelled through its cancellation
+ * slot, so WebRTC's late callback is dropped. Cancelling the caller still completes
+ * with the operation's own cancellation error, so the two can be told apart.
+ *
+ *   auto offer = co_await librtc::with_timeout(pc->create_offer(), 500ms,
+ *                                              librtc::PeerConnectionError::Timeout);
+ */
+template <typename T, typename E>
+boost::asio::awaitable<Result<T, E>> with_timeout(boost::asio::awaitable<Result<T, E>> operation,
+                                                  std::chrono::milliseconds timeout,
+                                                  std::type_identity_t<E> timeout_error) {
+  using namespace boost::asio::experimental::awaitable_operators;
+  boost::asio::steady_timer timer(co_await boost::asio::this_coro::executor, timeout);
+  // The loser is cancelled; for the operation that completes its AsyncBridge at once.
+  auto result = co_await (std::move(operation) || timer.async_wait(boost::asio::use_awaitable));
+  if (result.index() == 1) {
+    co_return Err(timeout_error);
+  }
+  co_return std::move(std::get<0>(result));
+}
+
+}  // namespace librtc
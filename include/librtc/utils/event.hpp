@@ -1,8 +1,13 @@
 #pragma once
 
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <librtc/utils/atomic_snapshot.hpp>
 #include <memory>
 #include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -19,12 +24,202 @@ namespace librtc {
     on_##name()(std::move(context), std::forward<F>(handler)); \
   }
 
+// Inline storage of InplaceFunction by default: room for the weak_ptr added by
+// Event::connect plus a handler capturing a few pointers.
+inline constexpr std::size_t kInplaceFunctionCapacity = 48;
+
+template <typename Signature, std::size_t Capacity = kInplaceFunctionCapacity>
+class InplaceFunction;
+
+/**
+ * InplaceFunction is a move-only std::function replacement that stores callables of
+ * up to Capacity bytes inline. Larger callables are moved to the heap, so any
+ * callable is accepted, but handlers on hot paths should stay within the buffer.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class InplaceFunction<R(Args...), Capacity> {
+ public:
+  InplaceFunction() = default;
+
+  template <typename F>
+    requires(!std::is_same_v<std::decay_t<F>, InplaceFunction> &&
+             std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+  InplaceFunction(F&& f) {  // NOLINT(google-explicit-constructor)
+    using Callable = std::decay_t<F>;
+    if constexpr (fits_inline<Callable>()) {
+      ::new (storage_) Callable(std::forward<F>(f));
+      ops_ = &kInlineOps<Callable>;
+    } else {
+      *reinterpret_cast<Callable**>(storage_) = new Callable(std::forward<F>(f));
+      ops_ = &kHeapOps<Callable>;
+    }
+  }
+
+  InplaceFunction(InplaceFunction&& other) noexcept : ops_(other.ops_) {
+    if (ops_) {
+      ops_->move(storage_, other.storage_);
+      other.ops_ = nullptr;
+    }
+  }
+
+  InplaceFunction& operator=(InplaceFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+      if (other.ops_) {
+        other.ops_->move(storage_, other.storage_);
+        ops_ = std::exchange(other.ops_, nullptr);
+      }
+    }
+    return *this;
+  }
+
+  InplaceFunction(const InplaceFunction&) = delete;
+  InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+  ~InplaceFunction() {
+    reset();
+  }
+
+  R operator()(Args... args) {
+    return ops_->invoke(storage_, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const {
+    return ops_ != nullptr;
+  }
+
+ private:
+  struct Ops {
+    R (*invoke)(void* storage, Args&&... args);
+    // Move-constructs into dst and destroys the source.
+    void (*move)(void* dst, void* src);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Callable>
+  static constexpr bool fits_inline() {
+    return sizeof(Callable) <= Capacity && alignof(Callable) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<Callable>;
+  }
+
+  template <typename Callable>
+  static constexpr Ops kInlineOps = {
+      [](void* storage, Args&&... args) -> R {
+        return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+      },
+      [](void* dst, void* src) {
+        auto* source = static_cast<Callable*>(src);
+        ::new (dst) Callable(std::move(*source));
+        source->~Callable();
+      },
+      [](void* storage) { static_cast<Callable*>(storage)->~Callable(); }};
+
+  template <typename Callable>
+  static constexpr Ops kHeapOps = {
+      [](void* storage, Args&&... args) -> R {
+        return (**static_cast<Callable**>(storage))(std::forward<Args>(args)...);
+      },
+      [](void* dst, void* src) {
+        *static_cast<Callable**>(dst) = *static_cast<Callable**>(src);
+      },
+      [](void* storage) { delete *static_cast<Callable**>(storage); }};
+
+  void reset() {
+    if (ops_) {
+      ops_->destroy(storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char storage_[Capacity];
+  const Ops* ops_ = nullptr;
+};
+
+namespace detail {
+
+struct SubscriptionEntry {
+  std::atomic<bool> connected{true};
+};
+
+class SubscriptionRegistry {
+ public:
+  virtual ~SubscriptionRegistry() = default;
+  virtual void disconnect(SubscriptionEntry& entry) = 0;
+};
+
+}  // namespace detail
+
+/**
+ * Subscription is the scoped handle returned by Event::subscribe, connect_strong and
+ * connect_raw. Destroying it, or calling disconnect(), removes the handler in amortized
+ * constant time. release() detaches the handle and leaves the handler connected for as
+ * long as its context lives.
+ *
+ * The handle may outlive the event source. A handler may still be running on
+ * another thread when disconnect() returns, but it is not called by later emits.
+ */
+class [[nodiscard]] Subscription {
+ public:
+  Subscription() = default;
+
+  Subscription(std::weak_ptr<detail::SubscriptionRegistry> registry,
+               std::weak_ptr<detail::SubscriptionEntry> entry)
+      : registry_(std::move(registry)), entry_(std::move(entry)) {}
+
+  Subscription(Subscription&&) noexcept = default;
+
+  Subscription& operator=(Subscription&& other) noexcept {
+    if (this != &other) {
+      disconnect();
+      registry_ = std::move(other.registry_);
+      entry_ = std::move(other.entry_);
+    }
+    return *this;
+  }
+
+  Subscription(const Subscription&) = delete;
+  Subscription& operator=(const Subscription&) = delete;
+
+  ~Subscription() {
+    disconnect();
+  }
+
+  void disconnect() {
+    auto registry = registry_.lock();
+    auto entry = entry_.lock();
+    if (registry && entry) {
+      registry->disconnect(*entry);
+    }
+    release();
+  }
+
+  void release() {
+    registry_.reset();
+    entry_.reset();
+  }
+
+  bool connected() const {
+    auto entry = entry_.lock();
+    return entry && entry->connected.load(std::memory_order_acquire) && !registry_.expired();
+  }
+
+ private:
+  std::weak_ptr<detail::SubscriptionRegistry> registry_;
+  std::weak_ptr<detail::SubscriptionEntry> entry_;
+};
+
 /**
  * Event is the public interface for subscribing to events.
+ *
+ * Handlers are not serialized: when the source emits from several threads at once,
+ * the same handler object runs concurrently, so handlers must be reentrant. State a
+ * handler mutates, including its own captures, needs its own synchronization.
  */
 template <typename... Args>
 class Event {
  public:
+  using Handler = InplaceFunction<void(Args...)>;
+
   virtual ~Event() = default;
 
   /**
@@ -35,12 +230,52 @@ class Event {
    */
   template <typename T, typename F>
   void connect(std::weak_ptr<T> context, F&& handler) {
-    subscribe_internal(context,
-                       [context, handler = std::forward<F>(handler)](Args... args) mutable {
-                         if (auto locked = context.lock()) {
-                           handler(*locked, std::forward<Args>(args)...);
-                         }
-                       });
+    subscribe(std::move(context), std::forward<F>(handler)).release();
+  }
+
+  /**
+   * Like connect, but returns a scoped handle that also removes the handler when it is
+   * destroyed or disconnected, whichever comes first.
+   */
+  template <typename T, typename F>
+  Subscription subscribe(std::weak_ptr<T> context, F&& handler) {
+    std::weak_ptr<void> tracker = context;
+    return subscribe_internal(std::move(tracker),
+                              [context = std::move(context),
+                               handler = std::forward<F>(handler)](Args... args) mutable {
+                                if (auto locked = context.lock()) {
+                                  handler(*locked, std::forward<Args>(args)...);
+                                }
+                              });
+  }
+
+  /**
+   * Subscribe with a context that the subscription keeps alive. Dispatch skips the
+   * weak_ptr lock, but the context lives until the handle disconnects or the event
+   * source dies: do not capture anything that owns the source in a released handle.
+   */
+  template <typename T, typename F>
+  Subscription connect_strong(std::shared_ptr<T> context, F&& handler) {
+    return subscribe_internal(std::nullopt,
+                              [context = std::move(context),
+                               handler = std::forward<F>(handler)](Args... args) mutable {
+                                handler(*context, std::forward<Args>(args)...);
+                              });
+  }
+
+  /**
+   * Subscribe with a context the caller owns. Dispatch is a single indirect call.
+   * disconnect() does not wait for a handler already running on another thread, so
+   * the context must outlive both the handle and any emit in progress when it
+   * disconnects. Disconnecting on the thread or executor that delivers the event, or
+   * after the source has stopped emitting (for example once it is closed), is enough.
+   */
+  template <typename T, typename F>
+  Subscription connect_raw(T* context, F&& handler) {
+    return subscribe_internal(std::nullopt,
+                              [context, handler = std::forward<F>(handler)](Args... args) mutable {
+                                handler(*context, std::forward<Args>(args)...);
+                              });
   }
 
   /**
@@ -52,52 +287,110 @@ class Event {
   }
 
  protected:
-  virtual void subscribe_internal(std::weak_ptr<void> tracker,
-                                  std::function<void(Args...)> handler) = 0;
+  // tracker is std::nullopt for subscriptions that never expire on their own.
+  virtual Subscription subscribe_internal(std::optional<std::weak_ptr<void>> tracker,
+                                          Handler handler) = 0;
 };
 
 /**
  * EventSource manages a list of subscriptions and can emit events.
  * It implements the Event interface for subscription.
+ *
+ * emit() reads an immutable snapshot of the subscriptions, so it takes no lock and
+ * allocates nothing. The cost moves to subscribing: every subscribe copies the list
+ * into a new one, dropping entries whose tracker has expired, so it is O(n) in time
+ * and allocates, and subscribing n handlers is O(n^2). Disconnecting only clears a
+ * flag that emit() checks and is amortized O(1); the list is rebuilt once
+ * disconnected entries make up half of it. Handlers connected during an emit are
+ * called from the next one on.
  */
 template <typename... Args>
 class EventSource : public Event<Args...> {
  public:
-  using Handler = std::function<void(Args...)>;
+  using Handler = typename Event<Args...>::Handler;
 
-  struct Subscription {
-    std::weak_ptr<void> tracker;
+  void emit(Args... args) {
+    auto entries = registry_->entries.read();
+    for (const auto& entry : *entries) {
+      if (entry->connected.load(std::memory_order_acquire)) {
+        // Arguments are passed as lvalues: every handler must see the same values.
+        entry->handler(args...);
+      }
+    }
+  }
+
+ protected:
+  Subscription subscribe_internal(std::optional<std::weak_ptr<void>> tracker,
+                                  Handler handler) override {
+    auto entry = std::make_shared<Entry>(std::move(tracker), std::move(handler));
+    registry_->add(entry);
+    return Subscription(registry_, entry);
+  }
+
+ private:
+  // Entries are shared between snapshots, so rebuilding the list never copies a handler.
+  struct Entry : detail::SubscriptionEntry {
+    Entry(std::optional<std::weak_ptr<void>> tracker, Handler handler)
+        : tracker(std::move(tracker)), handler(std::move(handler)) {}
+
+    bool alive() const {
+      return connected.load(std::memory_order_acquire) && (!tracker || !tracker->expired());
+    }
+
+    std::optional<std::weak_ptr<void>> tracker;
     Handler handler;
   };
 
-  void emit(Args... args) {
-    std::vector<Handler> targets;
-    {
+  using Entries = std::vector<std::shared_ptr<Entry>>;
+
+  class Registry : public detail::SubscriptionRegistry {
+   public:
+    void add(std::shared_ptr<Entry> entry) {
       std::lock_guard lock(mutex_);
-      for (auto it = subscriptions_.begin(); it != subscriptions_.end();) {
-        if (it->tracker.expired()) {
-          it = subscriptions_.erase(it);
-        } else {
-          targets.push_back(it->handler);
-          ++it;
-        }
+      rebuild(std::move(entry));
+    }
+
+    void disconnect(detail::SubscriptionEntry& entry) override {
+      if (!entry.connected.exchange(false, std::memory_order_acq_rel)) {
+        return;
+      }
+      std::lock_guard lock(mutex_);
+      if (++disconnected_ * 2 > size_) {
+        rebuild(nullptr);
       }
     }
 
-    for (auto& handler : targets) {
-      handler(std::forward<Args>(args)...);
+    AtomicSnapshot<Entries> entries;
+
+   private:
+    // Drops disconnected and expired entries, optionally appending one. Every entry
+    // is rebuilt away at most once, so disconnect stays amortized O(1).
+    void rebuild(std::shared_ptr<Entry> added) {
+      entries.update([&](const Entries& current) {
+        Entries next;
+        next.reserve(current.size() + 1);
+        for (const auto& existing : current) {
+          if (existing->alive()) {
+            next.push_back(existing);
+          }
+        }
+        if (added) {
+          next.push_back(std::move(added));
+        }
+        size_ = next.size();
+        return next;
+      });
+      // disconnect() counts under mutex_, after this reset. An entry it already saw
+      // dropped above is counted anyway, which only brings the next rebuild forward.
+      disconnected_ = 0;
     }
-  }
 
- protected:
-  void subscribe_internal(std::weak_ptr<void> tracker, Handler handler) override {
-    std::lock_guard lock(mutex_);
-    subscriptions_.push_back({std::move(tracker), std::move(handler)});
-  }
+    std::mutex mutex_;
+    std::size_t size_ = 0;
+    std::size_t disconnected_ = 0;
+  };
 
- private:
-  std::mutex mutex_;
-  std::vector<Subscription> subscriptions_;
+  std::shared_ptr<Registry> registry_ = std::make_shared<Registry>();
 };
 
 }  // namespace librtc
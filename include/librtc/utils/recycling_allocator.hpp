@@ -0,0 +1,252 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace librtc {
+namespace detail {
+
+/**
+ * Per-thread cache of small memory blocks for short-lived asynchronous state.
+ *
+ * Blocks come in a few size classes and remember the pool of the thread that
+ * allocated them. Freeing on that thread pushes the block onto a plain free list;
+ * freeing on any other thread (the usual case when WebRTC completes an operation
+ * started on the executor) pushes it onto the owner's lock-free remote list, which
+ * the owner reclaims on its next allocation. A pool outlives its thread: at thread
+ * exit it is marked orphaned, late frees (remote ones, and those from thread_local
+ * destructors that run after it) go straight back to the heap, and the pool deletes
+ * itself once the last block it handed out has come back.
+ */
+class RecyclingPool {
+ public:
+  static void* allocate(std::size_t size) {
+    auto size_class = class_of(size);
+    if (size_class == kNoClass) {
+      return init_header(::operator new(kHeaderSize + size), nullptr, kNoClass);
+    }
+
+    auto* pool = current();
+    if (pool) {
+      if (auto* block = pool->take(size_class)) {
+        return block;
+      }
+      pool->refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return init_header(::operator new(kHeaderSize + kClassSizes[size_class]), pool, size_class);
+  }
+
+  static void deallocate(void* p) noexcept {
+    if (!p) {
+      return;
+    }
+    auto* header = header_of(p);
+    auto* owner = header->owner;
+    if (!owner) {
+      ::operator delete(header);
+      return;
+    }
+    if (owner == current()) {
+      owner->give(static_cast<Block*>(p), header->size_class);
+    } else {
+      owner->give_remote(static_cast<Block*>(p));
+    }
+  }
+
+ private:
+  static constexpr std::array<std::size_t, 5> kClassSizes = {64, 128, 256, 512, 1024};
+  static constexpr std::size_t kNoClass = kClassSizes.size();
+  static constexpr std::size_t kMaxCachedPerClass = 256;
+  static constexpr std::size_t kHeaderSize = alignof(std::max_align_t);
+
+  struct Header {
+    RecyclingPool* owner;
+    std::size_t size_class;
+  };
+  static_assert(sizeof(Header) <= kHeaderSize);
+
+  struct Block {
+    Block* next;
+  };
+
+  // The calling thread's pool. Trivially destructible, so it stays readable while
+  // other thread_locals are destroyed at thread exit, after ThreadExit has run; frees
+  // from their destructors then find exited set and take the remote path.
+  struct ThreadState {
+    RecyclingPool* pool;
+    bool exited;
+  };
+  static_assert(std::is_trivially_destructible_v<ThreadState>);
+
+  static ThreadState& thread_state() {
+    thread_local ThreadState state{};
+    return state;
+  }
+
+  // Orphans the thread's pool when the thread exits. Never touched again afterwards.
+  struct ThreadExit {
+    ~ThreadExit() {
+      auto& state = thread_state();
+      state.exited = true;
+      state.pool->orphan();
+    }
+  };
+
+  static RecyclingPool* current() {
+    auto& state = thread_state();
+    if (state.exited) {
+      return nullptr;
+    }
+    if (!state.pool) {
+      // Deleted by release() once the thread has exited and no block points here.
+      state.pool = new RecyclingPool();
+      thread_local ThreadExit exit;
+    }
+    return state.pool;
+  }
+
+  static std::size_t class_of(std::size_t size) {
+    for (std::size_t i = 0; i < kClassSizes.size(); ++i) {
+      if (size <= kClassSizes[i]) {
+        return i;
+      }
+    }
+    return kNoClass;
+  }
+
+  static Header* header_of(void* p) {
+    return reinterpret_cast<Header*>(static_cast<std::byte*>(p) - kHeaderSize);
+  }
+
+  static void* init_header(void* raw, RecyclingPool* owner, std::size_t size_class) {
+    ::new (raw) Header{owner, size_class};
+    return static_cast<std::byte*>(raw) + kHeaderSize;
+  }
+
+  static Block* orphaned_marker() {
+    return reinterpret_cast<Block*>(std::uintptr_t{1});
+  }
+
+  void* take(std::size_t size_class) {
+    if (!free_[size_class]) {
+      reclaim_remote();
+    }
+    auto* block = free_[size_class];
+    if (!block) {
+      return nullptr;
+    }
+    free_[size_class] = block->next;
+    --cached_[size_class];
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    return block;
+  }
+
+  // Owner thread only; the thread's own reference keeps the pool alive.
+  void give(Block* block, std::size_t size_class) {
+    cache(block, size_class);
+    refs_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void cache(Block* block, std::size_t size_class) {
+    if (cached_[size_class] >= kMaxCachedPerClass) {
+      ::operator delete(header_of(block));
+      return;
+    }
+    block->next = free_[size_class];
+    free_[size_class] = block;
+    ++cached_[size_class];
+  }
+
+  void give_remote(Block* block) {
+    auto* head = remote_.load(std::memory_order_acquire);
+    do {
+      if (head == orphaned_marker()) {
+        ::operator delete(header_of(block));
+        break;
+      }
+      block->next = head;
+    } while (!remote_.compare_exchange_weak(head, block, std::memory_order_release,
+                                            std::memory_order_acquire));
+    release();
+  }
+
+  void reclaim_remote() {
+    auto* block = remote_.exchange(nullptr, std::memory_order_acquire);
+    while (block) {
+      auto* next = block->next;
+      cache(block, header_of(block)->size_class);
+      block = next;
+    }
+  }
+
+  void orphan() {
+    auto* remote = remote_.exchange(orphaned_marker(), std::memory_order_acq_rel);
+    for (auto* list : {remote, free_[0], free_[1], free_[2], free_[3], free_[4]}) {
+      while (list) {
+        auto* next = list->next;
+        ::operator delete(header_of(list));
+        list = next;
+      }
+    }
+    free_ = {};
+    cached_ = {};
+    release();
+  }
+
+  // One reference per block handed out plus one for the owning thread.
+  void release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::array<Block*, kClassSizes.size()> free_{};
+  std::array<std::size_t, kClassSizes.size()> cached_{};
+  std::atomic<Block*> remote_{nullptr};
+  std::atomic<std::size_t> refs_{1};
+};
+
+}  // namespace detail
+
+/**
+ * Standard allocator backed by the per-thread RecyclingPool. Used by AsyncBridge as
+ * the default for handlers without an associated allocator, so bridged operations
+ * reuse memory instead of going through malloc.
+ */
+template <typename T>
+class RecyclingAllocator {
+ public:
+  using value_type = T;
+
+  RecyclingAllocator() noexcept = default;
+
+  template <typename U>
+  RecyclingAllocator(const RecyclingAllocator<U>&) noexcept {}  // NOLINT
+
+  T* allocate(std::size_t n) {
+    if constexpr (alignof(T) > alignof(std::max_align_t)) {
+      return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    } else {
+      return static_cast<T*>(detail::RecyclingPool::allocate(n * sizeof(T)));
+    }
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    if constexpr (alignof(T) > alignof(std::max_align_t)) {
+      ::operator delete(p, n * sizeof(T), std::align_val_t(alignof(T)));
+    } else {
+      detail::RecyclingPool::deallocate(p);
+    }
+  }
+
+  template <typename U>
+  bool operator==(const RecyclingAllocator<U>&) const noexcept {
+    return true;
+  }
+};
+
+}  // namespace librtc
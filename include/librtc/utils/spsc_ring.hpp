@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace librtc {
+
+/**
+ * Bounded, lock-free queue for exactly one producer thread and one consumer thread.
+ *
+ * Slots are allocated once up front, so pushing and popping never allocate. The
+ * capacity is rounded up to a power of two. head_ and tail_ live on separate cache
+ * lines, and each side keeps a cached copy of the other side's index so that it only
+ * touches the shared line when the ring looks full (producer) or empty (consumer).
+ */
+template <typename T>
+class SpscRing {
+ public:
+  explicit SpscRing(std::size_t capacity)
+      : capacity_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+        mask_(capacity_ - 1),
+        slots_(std::make_unique<std::optional<T>[]>(capacity_)) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  /**
+   * Producer side. Returns false, leaving \p value untouched, when the ring is full.
+   */
+  template <typename U>
+  bool try_push(U&& value) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ == capacity_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ == capacity_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_].emplace(std::forward<U>(value));
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Consumer side. Returns std::nullopt when the ring is empty.
+   */
+  std::optional<T> try_pop() {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) {
+        return std::nullopt;
+      }
+    }
+    auto& slot = slots_[head & mask_];
+    std::optional<T> value(std::move(slot));
+    slot.reset();
+    head_.store(head + 1, std::memory_order_release);
+    return value;
+  }
+
+  /**
+   * Consumer side. Exact for the consumer; the producer may add elements at any time.
+   */
+  bool empty() const {
+    return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Approximate number of queued elements, safe to call from any thread.
+   */
+  std::size_t size() const {
+    auto tail = tail_.load(std::memory_order_acquire);
+    auto head = head_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : 0;
+  }
+
+  std::size_t capacity() const {
+    return capacity_;
+  }
+
+ private:
+  static constexpr std::size_t kCacheLine = 64;
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  std::unique_ptr<std::optional<T>[]> slots_;
+
+  // Consumer-owned.
+  alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+  std::size_t cached_tail_ = 0;
+
+  // Producer-owned.
+  alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+  std::size_t cached_head_ = 0;
+};
+
+}  // namespace librtc
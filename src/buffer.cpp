@@ -0,0 +1,83 @@
+#include <librtc/buffer.hpp>
+
+#include "impl/buffer_access.hpp"
+
+namespace librtc {
+namespace {
+
+using Native = webrtc::CopyOnWriteBuffer;
+using detail::BufferAccess;
+
+}  // namespace
+
+Buffer::Buffer() {
+  static_assert(sizeof(Native) <= sizeof(storage_), "Buffer::storage_ is too small");
+  static_assert(alignof(Native) <= alignof(void*), "Buffer::storage_ is under-aligned");
+  new (storage_) Native();
+}
+
+Buffer::Buffer(std::size_t size) {
+  new (storage_) Native(size);
+}
+
+Buffer::Buffer(std::size_t size, std::size_t capacity) {
+  new (storage_) Native(size, capacity);
+}
+
+Buffer::Buffer(const Buffer& other) {
+  new (storage_) Native(BufferAccess::native(other));
+}
+
+Buffer::Buffer(Buffer&& other) noexcept {
+  new (storage_) Native(std::move(BufferAccess::native(other)));
+}
+
+Buffer& Buffer::operator=(const Buffer& other) {
+  BufferAccess::native(*this) = BufferAccess::native(other);
+  return *this;
+}
+
+Buffer& Buffer::operator=(Buffer&& other) noexcept {
+  BufferAccess::native(*this) = std::move(BufferAccess::native(other));
+  return *this;
+}
+
+Buffer::~Buffer() {
+  BufferAccess::native(*this).~Native();
+}
+
+Buffer Buffer::copy_of(std::span<const std::byte> data) {
+  return BufferAccess::wrap(Native(reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+}
+
+std::span<const std::byte> Buffer::data() const {
+  const auto& native = BufferAccess::native(*this);
+  return {reinterpret_cast<const std::byte*>(native.cdata()), native.size()};
+}
+
+std::span<std::byte> Buffer::mutable_data() {
+  auto& native = BufferAccess::native(*this);
+  return {reinterpret_cast<std::byte*>(native.MutableData()), native.size()};
+}
+
+std::size_t Buffer::size() const {
+  return BufferAccess::native(*this).size();
+}
+
+std::size_t Buffer::capacity() const {
+  return BufferAccess::native(*this).capacity();
+}
+
+void Buffer::resize(std::size_t size) {
+  BufferAccess::native(*this).SetSize(size);
+}
+
+void Buffer::reserve(std::size_t capacity) {
+  BufferAccess::native(*this).EnsureCapacity(capacity);
+}
+
+void Buffer::clear() {
+  BufferAccess::native(*this).Clear();
+}
+
+}  // namespace librtc
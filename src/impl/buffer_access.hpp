@@ -0,0 +1,29 @@
+#pragma once
+
+#include <rtc_base/copy_on_write_buffer.h>
+
+#include <librtc/buffer.hpp>
+#include <new>
+#include <utility>
+
+namespace librtc::detail {
+
+// The WebRTC storage of a Buffer, for the parts of the library that hand it to WebRTC.
+struct BufferAccess {
+  static webrtc::CopyOnWriteBuffer& native(Buffer& buffer) {
+    return *std::launder(reinterpret_cast<webrtc::CopyOnWriteBuffer*>(buffer.storage_));
+  }
+
+  static const webrtc::CopyOnWriteBuffer& native(const Buffer& buffer) {
+    return *std::launder(reinterpret_cast<const webrtc::CopyOnWriteBuffer*>(buffer.storage_));
+  }
+
+  // Wraps existing WebRTC storage without copying it.
+  static Buffer wrap(webrtc::CopyOnWriteBuffer storage) {
+    Buffer buffer;
+    native(buffer) = std::move(storage);
+    return buffer;
+  }
+};
+
+}  // namespace librtc::detail
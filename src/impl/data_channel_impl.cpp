@@ -2,27 +2,44 @@
 
 #include <rtc_base/copy_on_write_buffer.h>
 
+#include <algorithm>
+#include <boost/asio/post.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <librtc/errors/data_channel_error.hpp>
+#include <librtc/utils/async_bridge.hpp>
 #include <memory>
 #include <string>
 
+#include "buffer_access.hpp"
 #include "proxy/data_channel_observer_proxy.hpp"
 
 namespace librtc {
 
 std::shared_ptr<DataChannelImpl> DataChannelImpl::Create(
-    webrtc::scoped_refptr<webrtc::DataChannelInterface> native, std::shared_ptr<void> context) {
-  auto impl = std::make_shared<DataChannelImpl>(std::move(native), std::move(context));
+    webrtc::scoped_refptr<webrtc::DataChannelInterface> native, std::shared_ptr<void> context,
+    std::optional<boost::asio::any_io_executor> executor,
+    const EventDeliveryConfig& event_delivery) {
+  auto impl = std::make_shared<DataChannelImpl>(std::move(native), std::move(context),
+                                                std::move(executor), event_delivery);
   impl->init();
   return impl;
 }
 
 DataChannelImpl::DataChannelImpl(webrtc::scoped_refptr<webrtc::DataChannelInterface> native,
-                                 std::shared_ptr<void> context)
+                                 std::shared_ptr<void> context,
+                                 std::optional<boost::asio::any_io_executor> executor,
+                                 const EventDeliveryConfig& event_delivery)
     : native_(std::move(native)),
-      context_(std::move(context)) {}  // context_ acts as a lifetime anchor for the parent PC
+      context_(std::move(context)),  // context_ acts as a lifetime anchor for the parent PC
+      executor_(std::move(executor)) {
+  if (event_delivery.mode == EventDelivery::Executor && executor_) {
+    events_ = std::make_unique<EventQueue>(event_delivery);
+  }
+}
 
 DataChannelImpl::~DataChannelImpl() {
+  fail_waiters(DataChannelError::Closed);
+  close_receive_queue();
   if (native_) {
     native_->Close();
     native_->UnregisterObserver();
@@ -37,47 +54,198 @@ void DataChannelImpl::init() {
 void DataChannelImpl::init_internal() {
   if (native_) {
     observer_proxy_ = std::make_unique<DataChannelObserverProxy>(weak_from_this());
+    label_ = native_->label();
+    id_.store(native_->id(), std::memory_order_relaxed);
+    state_.store(convert_state(native_->state()), std::memory_order_relaxed);
+    buffered_amount_.store(native_->buffered_amount(), std::memory_order_relaxed);
     native_->RegisterObserver(observer_proxy_.get());
-    cached_state_ = convert_state(native_->state());
   }
 }
 
 void DataChannelImpl::handle_state_change() {
   auto new_state = convert_state(native_->state());
+  // The SCTP stream id of an in-band negotiated channel is assigned before it opens.
+  id_.store(native_->id(), std::memory_order_relaxed);
+  state_.store(new_state, std::memory_order_release);
+
+  if (new_state == DataChannelState::Closing || new_state == DataChannelState::Closed) {
+    fail_waiters(DataChannelError::Closed);
+  }
+  if (new_state == DataChannelState::Closed) {
+    close_receive_queue();
+  }
+
+  deliver([this, new_state]() { state_event.emit(new_state); });
+}
 
+void DataChannelImpl::handle_buffered_amount_change([[maybe_unused]] uint64_t sent_data_size) {
+  // Observer callbacks run on the network thread, so this read makes no proxy hop.
+  auto amount = native_->buffered_amount();
+  uint64_t previous;
+  {
+    // Published before waiters are taken under mutex_, so a waiter registering
+    // concurrently either sees the new generation or is woken below.
+    std::lock_guard lock(amount_mutex_);
+    previous = buffered_amount_.exchange(amount, std::memory_order_acq_rel);
+    amount_generation_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  auto low = low_threshold_.load(std::memory_order_relaxed);
+  if (amount > low) {
+    return;
+  }
+
+  std::vector<Waiter> waiters;
   {
     std::lock_guard lock(mutex_);
-    cached_state_ = new_state;
+    waiters.swap(low_threshold_waiters_);
   }
 
-  state_event.emit(new_state);
+  for (auto& waiter : waiters) {
+    waiter(Success());
+  }
+
+  if (previous > low) {
+    deliver([this]() { buffered_amount_low_event.emit(); });
+  }
 }
 
 void DataChannelImpl::handle_message(const webrtc::DataBuffer& buffer) {
-  DataChannel::MessageBuffer data{reinterpret_cast<const std::byte*>(buffer.data.data()),
-                                  buffer.data.size()};
+  // Copying the CopyOnWriteBuffer only takes a reference on WebRTC's storage.
+  Message message{.data = detail::BufferAccess::wrap(buffer.data), .is_binary = buffer.binary};
+
+  if (events_) {
+    // The queued handler owns a reference, so the span handed to on_message stays
+    // valid after WebRTC has reused its DataBuffer.
+    deliver([this, message]() {
+      message_event.emit(message.data.data(), message.is_binary);
+      owned_message_event.emit(message);
+    });
+  } else {
+    message_event.emit(message.data.data(), message.is_binary);
+    owned_message_event.emit(message);
+  }
 
-  message_event.emit(data, buffer.binary);
+  if (receive_queue_enabled_.load(std::memory_order_acquire)) {
+    enqueue_message(std::move(message));
+  }
 }
 
 Expected<void> DataChannelImpl::send(MessageBuffer data, bool is_binary) {
+  return send(Buffer::copy_of(data), is_binary);
+}
+
+Expected<void> DataChannelImpl::send(const Buffer& data, bool is_binary) {
+  return send_native(webrtc::DataBuffer(detail::BufferAccess::native(data), is_binary));
+}
+
+Expected<void> DataChannelImpl::send(Buffer&& data, bool is_binary) {
+  return send_native(
+      webrtc::DataBuffer(std::move(detail::BufferAccess::native(data)), is_binary));
+}
+
+Expected<void> DataChannelImpl::send_native(webrtc::DataBuffer buffer) {
   if (!native_) {
     return Err(DataChannelError::Closed);
   }
 
-  if (native_->state() != webrtc::DataChannelInterface::kOpen) {
+  if (state_.load(std::memory_order_acquire) != DataChannelState::Open) {
     return Err(DataChannelError::NotOpen);
   }
 
-  webrtc::DataBuffer buffer(
-      webrtc::CopyOnWriteBuffer(reinterpret_cast<const uint8_t*>(data.data()), data.size()),
-      is_binary);
-
-  if (native_->Send(buffer)) {
-    return Success();
-  } else {
+  auto size = buffer.size();
+  auto generation = amount_generation_.load(std::memory_order_acquire);
+  if (!native_->Send(buffer)) {
+    // The channel may have started closing since the cached state was read.
+    if (state_.load(std::memory_order_acquire) != DataChannelState::Open) {
+      return Err(DataChannelError::NotOpen);
+    }
     return Err(DataChannelError::BufferFull);
   }
+
+  std::lock_guard lock(amount_mutex_);
+  // A callback in between stored a native reading, which either includes these bytes
+  // or is corrected by the callback that reports them sent.
+  if (amount_generation_.load(std::memory_order_relaxed) == generation) {
+    buffered_amount_.fetch_add(size, std::memory_order_acq_rel);
+  }
+  return Success();
+}
+
+DataChannelImpl::AmountSample DataChannelImpl::sample_buffered_amount() const {
+  std::lock_guard lock(amount_mutex_);
+  return {.amount = buffered_amount_.load(std::memory_order_relaxed),
+          .generation = amount_generation_.load(std::memory_order_relaxed)};
+}
+
+DataChannelImpl::Task<void> DataChannelImpl::async_send(Buffer data, bool is_binary) {
+  if (!native_) {
+    co_return Err(DataChannelError::Closed);
+  }
+
+  while (true) {
+    auto sample = sample_buffered_amount();
+    if (sample.amount <= high_threshold_.load(std::memory_order_relaxed)) {
+      auto result = send(static_cast<const Buffer&>(data), is_binary);
+      if (result || result.error() != DataChannelError::BufferFull) {
+        co_return result;
+      }
+
+      // SCTP is full although the amount was below the high threshold. Waiting for
+      // the low threshold would complete immediately and spin.
+      sample = sample_buffered_amount();
+      if (sample.amount <= low_threshold_.load(std::memory_order_relaxed)) {
+        co_return result;
+      }
+    }
+
+    auto waited = co_await wait_buffered_amount_low(sample);
+    if (!waited) {
+      co_return waited;
+    }
+  }
+}
+
+DataChannelImpl::Task<void> DataChannelImpl::wait_buffered_amount_low(AmountSample sample) {
+  co_return co_await AsyncBridge<void, DataChannelError>::async_run(
+      executor_,
+      [self = shared_from_this(), sample](auto cb) {
+        {
+          std::lock_guard lock(self->mutex_);
+          auto state = self->state_.load(std::memory_order_acquire);
+          if (state == DataChannelState::Closing || state == DataChannelState::Closed) {
+            cb(Err(DataChannelError::Closed));
+            return;
+          }
+          // Suspend only if no callback has run since the sample was read: callbacks
+          // publish their generation before taking mutex_ to wake waiters, so a drain
+          // cannot slip between this check and the push. Otherwise the caller re-reads.
+          if (self->amount_generation_.load(std::memory_order_acquire) == sample.generation &&
+              sample.amount > self->low_threshold_.load(std::memory_order_relaxed)) {
+            self->low_threshold_waiters_.push_back(std::move(cb));
+            return;
+          }
+        }
+        cb(Success());
+      },
+      boost::asio::use_awaitable);
+}
+
+void DataChannelImpl::set_buffered_amount_thresholds(uint64_t high, uint64_t low) {
+  high_threshold_.store(high, std::memory_order_relaxed);
+  low_threshold_.store(std::min(low, high), std::memory_order_relaxed);
+}
+
+void DataChannelImpl::fail_waiters(DataChannelError error) {
+  std::vector<Waiter> waiters;
+  {
+    std::lock_guard lock(mutex_);
+    waiters.swap(low_threshold_waiters_);
+  }
+
+  for (auto& waiter : waiters) {
+    waiter(Err(error));
+  }
 }
 
 Expected<void> DataChannelImpl::send(std::string_view text) {
@@ -88,39 +256,181 @@ Expected<void> DataChannelImpl::send(const std::vector<std::byte>& data) {
   return send({data.data(), data.size()}, true);
 }
 
-void DataChannelImpl::close() {
-  if (native_) {
-    native_->Close();
+void DataChannelImpl::enable_receive_queue(const ReceiveQueueConfig& config) {
+  std::lock_guard lock(queue_mutex_);
+  receive_queue_config_ = config;
+  receive_queue_config_.capacity = std::max<std::size_t>(config.capacity, 1);
+  receive_queue_enabled_.store(true, std::memory_order_release);
+}
+
+void DataChannelImpl::enqueue_message(Message message) {
+  std::vector<Waiter> waiters;
+  {
+    std::lock_guard lock(queue_mutex_);
+    if (receive_queue_closed_) {
+      return;
+    }
+
+    if (receive_queue_.size() >= receive_queue_config_.capacity) {
+      switch (receive_queue_config_.overflow_policy) {
+        case ReceiveOverflowPolicy::DropOldest:
+          receive_queue_.pop_front();
+          receive_queue_.push_back(std::move(message));
+          break;
+        case ReceiveOverflowPolicy::Error:
+          receive_queue_overflowed_ = true;
+          receive_queue_closed_ = true;
+          receive_queue_.clear();
+          break;
+      }
+    } else {
+      receive_queue_.push_back(std::move(message));
+    }
+    waiters.swap(readable_waiters_);
+  }
+
+  for (auto& waiter : waiters) {
+    waiter(Result<void, DataChannelError>{});
   }
 }
 
-std::string DataChannelImpl::label() const {
-  if (native_) {
-    return native_->label();
+void DataChannelImpl::close_receive_queue() {
+  std::vector<Waiter> waiters;
+  {
+    std::lock_guard lock(queue_mutex_);
+    receive_queue_closed_ = true;
+    waiters.swap(readable_waiters_);
   }
 
-  return "";
+  // Woken receivers drain what is left and then observe the closed queue.
+  for (auto& waiter : waiters) {
+    waiter(Result<void, DataChannelError>{});
+  }
 }
 
-int DataChannelImpl::id() const {
-  if (native_) {
-    return native_->id();
+template <typename Sink>
+std::optional<Result<void, DataChannelError>> DataChannelImpl::pop_messages(
+    std::size_t max_messages, Sink&& sink) {
+  std::lock_guard lock(queue_mutex_);
+  if (receive_queue_overflowed_) {
+    return Err(DataChannelError::ReceiveQueueOverflow);
+  }
+
+  if (!receive_queue_.empty()) {
+    auto count = std::min(max_messages, receive_queue_.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      sink(std::move(receive_queue_.front()));
+      receive_queue_.pop_front();
+    }
+    return Result<void, DataChannelError>{};
+  }
+
+  if (receive_queue_closed_) {
+    return Err(DataChannelError::Closed);
   }
 
-  return -1;
+  return std::nullopt;
 }
 
-uint64_t DataChannelImpl::buffered_amount() const {
+DataChannelImpl::Task<void> DataChannelImpl::wait_readable() {
+  co_return co_await AsyncBridge<void, DataChannelError>::async_run(
+      executor_,
+      [self = shared_from_this()](auto cb) {
+        {
+          std::lock_guard lock(self->queue_mutex_);
+          if (self->receive_queue_.empty() && !self->receive_queue_closed_) {
+            self->readable_waiters_.push_back(std::move(cb));
+            return;
+          }
+        }
+        cb(Result<void, DataChannelError>{});
+      },
+      boost::asio::use_awaitable);
+}
+
+DataChannelImpl::Task<Message> DataChannelImpl::receive() {
+  if (!receive_queue_enabled_.load(std::memory_order_acquire)) {
+    enable_receive_queue({});
+  }
+
+  while (true) {
+    std::optional<Message> message;
+    auto status = pop_messages(1, [&message](Message&& m) { message = std::move(m); });
+    if (status) {
+      if (!*status) {
+        co_return Err(status->error());
+      }
+      co_return std::move(*message);
+    }
+
+    auto waited = co_await wait_readable();
+    if (!waited) {
+      co_return Err(waited.error());
+    }
+  }
+}
+
+DataChannelImpl::Task<std::vector<Message>> DataChannelImpl::receive_batch(
+    std::size_t max_messages) {
+  if (max_messages == 0) {
+    co_return Err(DataChannelError::InvalidArgument);
+  }
+  if (!receive_queue_enabled_.load(std::memory_order_acquire)) {
+    enable_receive_queue({});
+  }
+
+  while (true) {
+    std::vector<Message> messages;
+    auto status = pop_messages(max_messages,
+                               [&messages](Message&& m) { messages.push_back(std::move(m)); });
+    if (status) {
+      if (!*status) {
+        co_return Err(status->error());
+      }
+      co_return std::move(messages);
+    }
+
+    auto waited = co_await wait_readable();
+    if (!waited) {
+      co_return Err(waited.error());
+    }
+  }
+}
+
+void DataChannelImpl::close() {
   if (native_) {
-    return native_->buffered_amount();
+    native_->Close();
   }
+}
+
+std::string DataChannelImpl::label() const {
+  return label_;
+}
+
+int DataChannelImpl::id() const {
+  return id_.load(std::memory_order_relaxed);
+}
 
-  return 0;
+uint64_t DataChannelImpl::buffered_amount() const {
+  return buffered_amount_.load(std::memory_order_acquire);
 }
 
 DataChannelState DataChannelImpl::state() const {
-  std::lock_guard lock(mutex_);
-  return cached_state_;
+  return state_.load(std::memory_order_acquire);
+}
+
+DeliveryStats DataChannelImpl::delivery_stats() const {
+  return events_ ? events_->stats() : DeliveryStats{};
+}
+
+void DataChannelImpl::schedule_drain() {
+  boost::asio::post(*executor_, [weak = weak_from_this()]() {
+    if (auto self = weak.lock()) {
+      if (self->events_->drain()) {
+        self->schedule_drain();
+      }
+    }
+  });
 }
 
 DataChannelState DataChannelImpl::convert_state(
@@ -2,9 +2,20 @@
 
 #include <api/data_channel_interface.h>
 
+#include <atomic>
+#include <boost/asio/any_io_executor.hpp>
+#include <deque>
 #include <librtc/data_channel.hpp>
+#include <librtc/errors/data_channel_error.hpp>
+#include <librtc/utils/async_bridge.hpp>
 #include <librtc/utils/event.hpp>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "event_queue.hpp"
 
 namespace librtc {
 
@@ -14,10 +25,14 @@ class DataChannelImpl : public DataChannel, public std::enable_shared_from_this<
  public:
   static std::shared_ptr<DataChannelImpl> Create(
       webrtc::scoped_refptr<webrtc::DataChannelInterface> native,
-      std::shared_ptr<void> context = nullptr);
+      std::shared_ptr<void> context = nullptr,
+      std::optional<boost::asio::any_io_executor> executor = std::nullopt,
+      const EventDeliveryConfig& event_delivery = {});
 
-  explicit DataChannelImpl(webrtc::scoped_refptr<webrtc::DataChannelInterface> native,
-                           std::shared_ptr<void> context);
+  DataChannelImpl(webrtc::scoped_refptr<webrtc::DataChannelInterface> native,
+                  std::shared_ptr<void> context,
+                  std::optional<boost::asio::any_io_executor> executor,
+                  const EventDeliveryConfig& event_delivery);
 
   ~DataChannelImpl() override;
 
@@ -27,13 +42,28 @@ class DataChannelImpl : public DataChannel, public std::enable_shared_from_this<
   Event<MessageBuffer, bool>& on_message() override {
     return message_event;
   }
+  Event<const Message&>& on_owned_message() override {
+    return owned_message_event;
+  }
   Event<DataChannelState>& on_state_change() override {
     return state_event;
   }
+  Event<>& on_buffered_amount_low() override {
+    return buffered_amount_low_event;
+  }
 
   Expected<void> send(MessageBuffer data, bool is_binary) override;
   Expected<void> send(std::string_view text) override;
   Expected<void> send(const std::vector<std::byte>& data) override;
+  Expected<void> send(const Buffer& data, bool is_binary) override;
+  Expected<void> send(Buffer&& data, bool is_binary) override;
+
+  Task<void> async_send(Buffer data, bool is_binary) override;
+  void set_buffered_amount_thresholds(uint64_t high, uint64_t low) override;
+
+  void enable_receive_queue(const ReceiveQueueConfig& config) override;
+  Task<Message> receive() override;
+  Task<std::vector<Message>> receive_batch(std::size_t max_messages) override;
 
   void close() override;
 
@@ -41,27 +71,100 @@ class DataChannelImpl : public DataChannel, public std::enable_shared_from_this<
   int id() const override;
   uint64_t buffered_amount() const override;
   DataChannelState state() const override;
+  DeliveryStats delivery_stats() const override;
 
   // Handlers for proxy
   void handle_state_change();
   void handle_message(const webrtc::DataBuffer& buffer);
-  void handle_buffered_amount_change(uint64_t previous_amount) {}
+  void handle_buffered_amount_change(uint64_t sent_data_size);
 
   // Internal event sources
   EventSource<MessageBuffer, bool> message_event;
+  EventSource<const Message&> owned_message_event;
   EventSource<DataChannelState> state_event;
+  EventSource<> buffered_amount_low_event;
 
  private:
+  // Completion of a suspended async_send/receive, invoked from the WebRTC thread.
+  using Waiter = AsyncBridge<void, DataChannelError>::Completion;
+
   void init_internal();
+
+  // Runs emit on the calling WebRTC thread, or queues it for the executor.
+  template <typename F>
+  void deliver(F&& emit) {
+    if (!events_) {
+      emit();
+      return;
+    }
+    if (events_->push(std::forward<F>(emit))) {
+      schedule_drain();
+    }
+  }
+  void schedule_drain();
+
+  // The cached buffered amount and the number of buffered-amount callbacks that had
+  // published a reading when it was taken.
+  struct AmountSample {
+    uint64_t amount;
+    uint64_t generation;
+  };
+
+  Expected<void> send_native(webrtc::DataBuffer buffer);
+  AmountSample sample_buffered_amount() const;
+  Task<void> wait_buffered_amount_low(AmountSample sample);
+  void fail_waiters(DataChannelError error);
+
+  void enqueue_message(Message message);
+  void close_receive_queue();
+  // Hands up to max_messages queued messages to sink, or reports why nothing can be
+  // popped. Returns std::nullopt when the caller has to wait.
+  template <typename Sink>
+  std::optional<Result<void, DataChannelError>> pop_messages(std::size_t max_messages,
+                                                             Sink&& sink);
+  Task<void> wait_readable();
   static DataChannelState convert_state(webrtc::DataChannelInterface::DataState native_state);
 
   webrtc::scoped_refptr<webrtc::DataChannelInterface> native_;
   // context_ keeps the parent PeerConnection alive to ensure underlying threads
   // and factory remain valid as long as this DataChannel exists.
   std::shared_ptr<void> context_;
+  std::optional<boost::asio::any_io_executor> executor_;
+  std::unique_ptr<EventQueue> events_;
   std::unique_ptr<DataChannelObserverProxy> observer_proxy_;
-  mutable std::mutex mutex_;
-  DataChannelState cached_state_ = DataChannelState::Closed;
+
+  // Published from the observer callbacks so the getters never call into the native
+  // proxy. The label cannot change and is captured once in init().
+  std::string label_;
+  std::atomic<int> id_{-1};
+  std::atomic<DataChannelState> state_{DataChannelState::Closed};
+
+  // Guards low_threshold_waiters_. Waiters are registered after checking state_ under
+  // it, and handle_state_change fails them under it after publishing a closing state.
+  std::mutex mutex_;
+
+  // Backpressure state, kept without calling into the native proxy. Sends add their
+  // size to buffered_amount_; OnBufferedAmountChange replaces it with WebRTC's reading
+  // and bumps amount_generation_. A send adds only if no callback has run since before
+  // its Send(), so bytes a callback already saw drain are never counted again. Both
+  // happen under amount_mutex_, which is never held across a native call.
+  mutable std::mutex amount_mutex_;
+  std::atomic<uint64_t> buffered_amount_{0};
+  std::atomic<uint64_t> amount_generation_{0};
+  std::atomic<uint64_t> high_threshold_{DataChannelConfig{}.buffered_amount_high_threshold};
+  std::atomic<uint64_t> low_threshold_{DataChannelConfig{}.buffered_amount_low_threshold};
+  std::vector<Waiter> low_threshold_waiters_;
+
+  // Receive queue state, guarded by queue_mutex_. An overflow under
+  // ReceiveOverflowPolicy::Error sets both receive_queue_overflowed_ and
+  // receive_queue_closed_ for good.
+  std::atomic<bool> receive_queue_enabled_{false};
+  std::mutex queue_mutex_;
+  ReceiveQueueConfig receive_queue_config_;
+  std::deque<Message> receive_queue_;
+  bool receive_queue_overflowed_ = false;
+  bool receive_queue_closed_ = false;
+  std::vector<Waiter> readable_waiters_;
 };
 
 }  // namespace librtc
@@ -0,0 +1,114 @@
+#include "description_templates.hpp"
+
+#include <rtc_base/crypto_random.h>
+
+#include <cstdint>
+#include <librtc/sdp.hpp>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace librtc {
+namespace {
+
+bool varies_per_session(const SdpLine& line) {
+  if (line.type == 'o' || line.type == 'c') {
+    return true;
+  }
+  if (!line.is_attribute()) {
+    return false;
+  }
+  auto name = line.attribute_name();
+  return name == "ice-ufrag" || name == "ice-pwd" || name == "fingerprint" ||
+         name == "candidate" || name == "end-of-candidates";
+}
+
+// Maps every distinct value to a fresh random one of the same length, so values
+// shared between m-sections (as with BUNDLE) stay shared.
+class RandomReplacements {
+ public:
+  std::string get(std::string_view original) {
+    for (const auto& [from, to] : values_) {
+      if (from == original) {
+        return to;
+      }
+    }
+    return values_
+        .emplace_back(std::string(original), webrtc::CreateRandomString(original.size()))
+        .second;
+  }
+
+ private:
+  std::vector<std::pair<std::string, std::string>> values_;
+};
+
+std::string patch(std::string_view sdp) {
+  RandomReplacements ufrags;
+  RandomReplacements passwords;
+  // Same range WebRTC draws its own session ids from.
+  auto session_id =
+      std::to_string(webrtc::CreateRandomId64() & std::numeric_limits<std::int64_t>::max());
+  return SdpEditor(sdp)
+      .transform_attribute("ice-ufrag", [&](std::string_view value) { return ufrags.get(value); })
+      .transform_attribute("ice-pwd",
+                           [&](std::string_view value) { return passwords.get(value); })
+      .set_session_id(std::move(session_id))
+      .build();
+}
+
+}  // namespace
+
+std::string DescriptionTemplates::offer_key(bool has_data_channels) {
+  return has_data_channels ? "offer/data" : "offer";
+}
+
+std::string DescriptionTemplates::answer_key(std::string_view remote_offer) {
+  std::string key = "answer\n";
+  key.reserve(remote_offer.size());
+  for (const auto& line : SdpLines(remote_offer)) {
+    if (varies_per_session(line)) {
+      continue;
+    }
+    auto text = line.text;
+    if (line.type == 'm') {
+      // m=<media> <port> <proto> ...: the port is the default candidate's.
+      auto port = text.find(' ');
+      auto proto = port == std::string_view::npos ? port : text.find(' ', port + 1);
+      if (proto != std::string_view::npos) {
+        key += text.substr(0, port);
+        text = text.substr(proto);
+      }
+    }
+    key += text;
+    key += '\n';
+  }
+  return key;
+}
+
+std::optional<SessionDescription> DescriptionTemplates::instantiate(
+    const std::string& key) const {
+  std::shared_ptr<const SessionDescription> description;
+  {
+    std::lock_guard lock(mutex_);
+    auto it = templates_.find(key);
+    if (it == templates_.end()) {
+      return std::nullopt;
+    }
+    description = it->second;
+  }
+  return SessionDescription{.type = description->type, .sdp = patch(description->sdp)};
+}
+
+void DescriptionTemplates::store(const std::string& key, const SessionDescription& description) {
+  // Gathered candidates belong to the connection that created the description.
+  if (SdpView(description.sdp).has_attribute("candidate")) {
+    return;
+  }
+
+  std::lock_guard lock(mutex_);
+  if (templates_.size() < kMaxTemplates && !templates_.contains(key)) {
+    templates_.emplace(key, std::make_shared<const SessionDescription>(description));
+  }
+}
+
+}  // namespace librtc
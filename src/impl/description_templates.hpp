@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <librtc/peer_connection.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace librtc {
+
+// Initial offers and answers of connections that share the context's certificate.
+// Such descriptions differ only in their ICE credentials and session id, so a later
+// connection can reuse a stored one after patching those instead of running JSEP.
+// Thread-safe.
+class DescriptionTemplates {
+ public:
+  // Bounds the number of answer shapes kept for differing remote offers.
+  static constexpr std::size_t kMaxTemplates = 64;
+
+  // Key of the initial offer of a connection with or without data channels.
+  static std::string offer_key(bool has_data_channels);
+  // Key of the answer to remote_offer: the offer without the attributes that differ
+  // between sessions (origin, ICE credentials, fingerprint, candidates, ports).
+  static std::string answer_key(std::string_view remote_offer);
+
+  // The template stored under key with fresh ICE credentials and session id.
+  std::optional<SessionDescription> instantiate(const std::string& key) const;
+  // Keeps description as the template for key. Descriptions with candidates are
+  // skipped, and the first template stored for a key is kept.
+  void store(const std::string& key, const SessionDescription& description);
+
+ private:
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const SessionDescription>> templates_;
+};
+
+}  // namespace librtc
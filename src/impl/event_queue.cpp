@@ -0,0 +1,97 @@
+#include "event_queue.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace librtc {
+
+EventQueue::EventQueue(const EventDeliveryConfig& config)
+    : ring_(config.queue_capacity), max_batch_(std::max<std::size_t>(config.max_batch, 1)) {}
+
+bool EventQueue::push(Task task) {
+  if (overflowing_.load(std::memory_order_acquire) || !ring_.try_push(std::move(task))) {
+    std::lock_guard lock(overflow_mutex_);
+    overflow_.push_back(std::move(task));
+    overflow_size_.store(overflow_.size(), std::memory_order_relaxed);
+    overflowing_.store(true, std::memory_order_release);
+    overflowed_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Only the producer raises max_depth_, so a plain load/store pair is enough.
+  auto current = depth();
+  if (current > max_depth_.load(std::memory_order_relaxed)) {
+    max_depth_.store(current, std::memory_order_relaxed);
+  }
+
+  return !scheduled_.exchange(true, std::memory_order_acq_rel);
+}
+
+bool EventQueue::drain() {
+  std::size_t count = 0;
+  while (count < max_batch_) {
+    auto task = ring_.try_pop();
+    if (!task) {
+      break;
+    }
+    (*task)();
+    ++count;
+  }
+
+  // While overflowing_ is set the producer does not touch the ring, so once the ring
+  // is empty everything left is in the overflow list, and it is all newer. The list is
+  // drained under the same budget; overflowing_ is cleared only once it is empty.
+  if (count < max_batch_ && overflowing_.load(std::memory_order_acquire) && ring_.empty()) {
+    std::vector<Task> batch;
+    {
+      std::lock_guard lock(overflow_mutex_);
+      auto take = std::min(max_batch_ - count, overflow_.size());
+      batch.reserve(take);
+      std::move(overflow_.begin(), overflow_.begin() + take, std::back_inserter(batch));
+      overflow_.erase(overflow_.begin(), overflow_.begin() + take);
+      overflow_size_.store(overflow_.size(), std::memory_order_relaxed);
+      if (overflow_.empty()) {
+        overflowing_.store(false, std::memory_order_release);
+      }
+    }
+    for (auto& task : batch) {
+      task();
+      ++count;
+    }
+  }
+
+  batches_.fetch_add(1, std::memory_order_relaxed);
+  events_.fetch_add(count, std::memory_order_relaxed);
+  if (count > max_batch_size_.load(std::memory_order_relaxed)) {
+    max_batch_size_.store(count, std::memory_order_relaxed);
+  }
+
+  if (count == max_batch_ && depth() > 0) {
+    // Yield the executor but stay scheduled.
+    return true;
+  }
+
+  // An event pushed after the last pop saw scheduled_ set and did not post. Reading
+  // the flag back with an RMW synchronizes with that push, so depth() below sees it.
+  scheduled_.exchange(false, std::memory_order_acq_rel);
+  if (depth() > 0 && !scheduled_.exchange(true, std::memory_order_acq_rel)) {
+    return true;
+  }
+  return false;
+}
+
+std::size_t EventQueue::depth() const {
+  return ring_.size() + overflow_size_.load(std::memory_order_relaxed);
+}
+
+DeliveryStats EventQueue::stats() const {
+  return {.batches = batches_.load(std::memory_order_relaxed),
+          .events = events_.load(std::memory_order_relaxed),
+          .max_batch_size = max_batch_size_.load(std::memory_order_relaxed),
+          .queue_depth = depth(),
+          .max_queue_depth = max_depth_.load(std::memory_order_relaxed),
+          .overflowed = overflowed_.load(std::memory_order_relaxed)};
+}
+
+}  // namespace librtc
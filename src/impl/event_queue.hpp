@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <librtc/event_delivery.hpp>
+#include <librtc/utils/event.hpp>
+#include <librtc/utils/spsc_ring.hpp>
+#include <mutex>
+
+namespace librtc {
+
+// Hands events raised on one WebRTC thread over to an executor in batches.
+//
+// push() is called by the single WebRTC thread that owns the observer callbacks and
+// returns true only for the first event of a batch; the owner then posts one task
+// that calls drain(). drain() runs on the executor, never concurrently with itself.
+// When the ring is full, events go to a mutex-guarded overflow list; the producer
+// keeps using the list until the consumer has emptied both, so order is preserved.
+class EventQueue {
+ public:
+  // Large enough to hold a queued Message inline.
+  using Task = InplaceFunction<void(), 64>;
+
+  explicit EventQueue(const EventDeliveryConfig& config);
+
+  // Producer side. Returns true when the caller has to schedule drain().
+  bool push(Task task);
+
+  // Consumer side. Runs up to max_batch queued tasks and returns true when more
+  // work is left and the caller has to schedule drain() again.
+  bool drain();
+
+  DeliveryStats stats() const;
+
+ private:
+  std::size_t depth() const;
+
+  SpscRing<Task> ring_;
+  const std::size_t max_batch_;
+  std::atomic<bool> scheduled_{false};
+
+  // Only ever set by the producer and cleared by the consumer under overflow_mutex_.
+  std::atomic<bool> overflowing_{false};
+  mutable std::mutex overflow_mutex_;
+  std::deque<Task> overflow_;
+  std::atomic<std::size_t> overflow_size_{0};
+
+  std::atomic<std::uint64_t> batches_{0};
+  std::atomic<std::uint64_t> events_{0};
+  std::atomic<std::uint64_t> max_batch_size_{0};
+  std::atomic<std::size_t> max_depth_{0};
+  std::atomic<std::uint64_t> overflowed_{0};
+};
+
+}  // namespace librtc
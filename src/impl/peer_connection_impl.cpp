@@ -1,94 +1,284 @@
 #include "peer_connection_impl.hpp"
 
-#include <api/audio_codecs/builtin_audio_decoder_factory.h>
-#include <api/audio_codecs/builtin_audio_encoder_factory.h>
-#include <api/create_peerconnection_factory.h>
 #include <api/jsep.h>
-#include <api/video_codecs/video_decoder_factory_template.h>
-#include <api/video_codecs/video_decoder_factory_template_dav1d_adapter.h>
-#include <api/video_codecs/video_decoder_factory_template_libvpx_vp8_adapter.h>
-#include <api/video_codecs/video_decoder_factory_template_libvpx_vp9_adapter.h>
-#include <api/video_codecs/video_decoder_factory_template_open_h264_adapter.h>
-#include <api/video_codecs/video_encoder_factory_template.h>
-#include <api/video_codecs/video_encoder_factory_template_libaom_av1_adapter.h>
-#include <api/video_codecs/video_encoder_factory_template_libvpx_vp8_adapter.h>
-#include <api/video_codecs/video_encoder_factory_template_libvpx_vp9_adapter.h>
-#include <api/video_codecs/video_encoder_factory_template_open_h264_adapter.h>
-#include <rtc_base/ssl_adapter.h>
+#include <api/units/time_delta.h>
+#include <p2p/base/port_allocator.h>
 
+#include <boost/asio/post.hpp>
 #include <librtc/errors/peer_connection_error.hpp>
 #include <librtc/utils/async_bridge.hpp>
+#include <librtc/utils/deadline.hpp>
 
 #include "data_channel_impl.hpp"
 #include "proxy/peer_connection_observer_proxy.hpp"
 #include "proxy/session_description_proxies.hpp"
 
 namespace librtc {
+namespace {
 
-PeerConnectionImpl::PeerConnectionImpl(std::optional<boost::asio::any_io_executor> executor)
-    : executor_(std::move(executor)) {}
+std::size_t count_candidates(const webrtc::SessionDescriptionInterface& desc) {
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < desc.number_of_mediasections(); ++i) {
+    count += desc.candidates(i)->count();
+  }
+  return count;
+}
 
-PeerConnectionImpl::~PeerConnectionImpl() {
-  close();
+// Applies candidates on the signaling thread and completes once WebRTC has reported
+// back for all of them, with the first error if any failed.
+void add_candidates_on_signaling_thread(
+    webrtc::scoped_refptr<webrtc::PeerConnectionInterface> pc,
+    std::vector<std::unique_ptr<webrtc::IceCandidateInterface>> candidates,
+    AsyncBridge<void, PeerConnectionError>::Completion cb) {
+  struct Batch {
+    AsyncBridge<void, PeerConnectionError>::Completion cb;
+    std::size_t remaining;
+    PeerConnectionError error = PeerConnectionError::Success;
+  };
+  auto batch =
+      std::make_shared<Batch>(Batch{.cb = std::move(cb), .remaining = candidates.size()});
+  for (auto& candidate : candidates) {
+    // Callbacks run on the signaling thread, in order.
+    pc->AddIceCandidate(std::move(candidate), [batch](webrtc::RTCError error) {
+      if (!error.ok() && batch->error == PeerConnectionError::Success) {
+        batch->error = convert_rtc_error(error);
+      }
+      if (--batch->remaining > 0) {
+        return;
+      }
+      if (batch->error == PeerConnectionError::Success) {
+        batch->cb(Success());
+      } else {
+        batch->cb(Err(batch->error));
+      }
+    });
+  }
 }
 
-void PeerConnectionImpl::set_threads_and_factory(
-    std::unique_ptr<webrtc::Thread> network_thread, std::unique_ptr<webrtc::Thread> worker_thread,
-    std::unique_ptr<webrtc::Thread> signaling_thread,
-    webrtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory) {
-  network_thread_ = std::move(network_thread);
-  worker_thread_ = std::move(worker_thread);
-  signaling_thread_ = std::move(signaling_thread);
-  pc_factory_ = std::move(factory);
+std::optional<int> to_milliseconds(const std::optional<std::chrono::milliseconds>& duration) {
+  if (!duration) {
+    return std::nullopt;
+  }
+  return static_cast<int>(duration->count());
+}
+
+Expected<void> apply_ice_config(const IceTransportConfig& ice,
+                                webrtc::PeerConnectionInterface::RTCConfiguration& rtc_config) {
+  using Rtc = webrtc::PeerConnectionInterface;
+  if (ice.candidate_pool_size < 0 || ice.min_port > ice.max_port) {
+    return Err(PeerConnectionError::InvalidArgument);
+  }
+
+  rtc_config.ice_candidate_pool_size = ice.candidate_pool_size;
+  auto& allocator = rtc_config.port_allocator_config;
+  switch (ice.candidate_filter) {
+    case IceCandidateFilter::All:
+      rtc_config.type = Rtc::kAll;
+      break;
+    case IceCandidateFilter::HostOnly:
+      // There is no host-only transport policy; skip the STUN and TURN ports instead.
+      rtc_config.type = Rtc::kAll;
+      allocator.flags |= webrtc::PORTALLOCATOR_DISABLE_STUN | webrtc::PORTALLOCATOR_DISABLE_RELAY;
+      break;
+    case IceCandidateFilter::NoHost:
+      rtc_config.type = Rtc::kNoHost;
+      break;
+    case IceCandidateFilter::RelayOnly:
+      rtc_config.type = Rtc::kRelay;
+      break;
+  }
+  if (!ice.tcp_candidates) {
+    rtc_config.tcp_candidate_policy = Rtc::kTcpCandidatePolicyDisabled;
+    allocator.flags |= webrtc::PORTALLOCATOR_DISABLE_TCP;
+  }
+  rtc_config.continual_gathering_policy =
+      ice.continual_gathering ? Rtc::GATHER_CONTINUALLY : Rtc::GATHER_ONCE;
+  allocator.min_port = ice.min_port;
+  allocator.max_port = ice.max_port;
+
+  rtc_config.ice_check_interval_strong_connectivity =
+      to_milliseconds(ice.check_interval_strong_connectivity);
+  rtc_config.ice_check_interval_weak_connectivity =
+      to_milliseconds(ice.check_interval_weak_connectivity);
+  rtc_config.ice_check_min_interval = to_milliseconds(ice.check_min_interval);
+  rtc_config.ice_unwritable_timeout = to_milliseconds(ice.unwritable_timeout);
+  rtc_config.ice_connection_receiving_timeout = to_milliseconds(ice.receiving_timeout);
+  return Success();
+}
+
+// Without a timeout the operation is returned as is, so it costs no extra frame.
+template <typename R>
+boost::asio::awaitable<R> with_deadline(boost::asio::awaitable<R> operation,
+                                        std::optional<std::chrono::milliseconds> timeout) {
+  if (!timeout) {
+    return operation;
+  }
+  return with_timeout(std::move(operation), *timeout, PeerConnectionError::Timeout);
+}
+
+}  // namespace
+
+PeerConnectionImpl::PeerConnectionImpl(std::shared_ptr<RtcContextImpl> context, std::size_t shard,
+                                       std::optional<boost::asio::any_io_executor> executor,
+                                       const PeerConnectionConfig& config)
+    : context_(std::move(context)),
+      shard_(shard),
+      executor_(std::move(executor)),
+      event_delivery_(config.event_delivery),
+      operation_timeout_(config.operation_timeout),
+      description_templates_(config.description_templates),
+      ice_candidate_batch_window_(config.ice_candidate_batch_window) {
+  if (event_delivery_.mode == EventDelivery::Executor && executor_) {
+    events_ = std::make_unique<EventQueue>(event_delivery_);
+  }
+}
+
+PeerConnectionImpl::~PeerConnectionImpl() {
+  close();
+  context_->release_shard(shard_);
 }
 
 void PeerConnectionImpl::set_pc(webrtc::scoped_refptr<webrtc::PeerConnectionInterface> pc) {
+  signaling_pc_ = pc;
   pc_ = std::move(pc);
 }
 
 PeerConnectionImpl::Task<SessionDescription> PeerConnectionImpl::create_offer() {
-  co_return co_await AsyncBridge<SessionDescription, PeerConnectionError>::async_run(
-      executor_,
-      [this](auto cb) {
-        pc_->CreateOffer(CreateDescriptionProxy::Create(std::move(cb)).get(),
-                         webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
-      },
-      boost::asio::use_awaitable);
+  auto key = template_key(webrtc::SdpType::kOffer);
+  if (auto description = instantiate_template(key)) {
+    co_return std::move(*description);
+  }
+  auto created = co_await with_deadline(
+      AsyncBridge<SessionDescription, PeerConnectionError>::async_run(
+          executor_,
+          [this](auto cb) {
+            pc_->CreateOffer(CreateDescriptionProxy::Create(std::move(cb)).get(),
+                             webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+          },
+          boost::asio::use_awaitable),
+      operation_timeout_);
+  store_template(key, created);
+  co_return created;
 }
 
 PeerConnectionImpl::Task<SessionDescription> PeerConnectionImpl::create_answer() {
-  co_return co_await AsyncBridge<SessionDescription, PeerConnectionError>::async_run(
-      executor_,
-      [this](auto cb) {
-        pc_->CreateAnswer(CreateDescriptionProxy::Create(std::move(cb)).get(),
-                          webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
-      },
-      boost::asio::use_awaitable);
+  auto key = template_key(webrtc::SdpType::kAnswer);
+  if (auto description = instantiate_template(key)) {
+    co_return std::move(*description);
+  }
+  auto created = co_await with_deadline(
+      AsyncBridge<SessionDescription, PeerConnectionError>::async_run(
+          executor_,
+          [this](auto cb) {
+            pc_->CreateAnswer(CreateDescriptionProxy::Create(std::move(cb)).get(),
+                              webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+          },
+          boost::asio::use_awaitable),
+      operation_timeout_);
+  store_template(key, created);
+  co_return created;
 }
 
-PeerConnectionImpl::Task<void> PeerConnectionImpl::set_local_description(
-    const SessionDescription& sdp) {
-  auto sdp_type_res = webrtc::SdpTypeFromString(sdp.type);
-  if (!sdp_type_res) {
-    co_return Err(PeerConnectionError::InvalidSdp);
+PeerConnectionImpl::Task<SessionDescription> PeerConnectionImpl::offer_and_set_local() {
+  auto key = template_key(webrtc::SdpType::kOffer);
+  if (auto description = instantiate_template(key)) {
+    auto applied = co_await set_local_description(SessionDescription(*description));
+    if (!applied) {
+      co_return Err(applied.error());
+    }
+    co_return std::move(*description);
   }
+  auto created = co_await with_deadline(
+      AsyncBridge<SessionDescription, PeerConnectionError>::async_run(
+          executor_,
+          [this](auto cb) {
+            pc_->CreateOffer(CreateAndSetLocalProxy::Create(weak_from_this(), std::move(cb)).get(),
+                             webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+          },
+          boost::asio::use_awaitable),
+      operation_timeout_);
+  store_template(key, created);
+  co_return created;
+}
 
-  webrtc::SdpParseError error;
-  auto session_desc = webrtc::CreateSessionDescription(*sdp_type_res, sdp.sdp, &error);
-  if (!session_desc) {
-    co_return Err(PeerConnectionError::InvalidSdp);
+PeerConnectionImpl::Task<SessionDescription> PeerConnectionImpl::answer_and_set_local() {
+  auto key = template_key(webrtc::SdpType::kAnswer);
+  if (auto description = instantiate_template(key)) {
+    auto applied = co_await set_local_description(SessionDescription(*description));
+    if (!applied) {
+      co_return Err(applied.error());
+    }
+    co_return std::move(*description);
+  }
+  auto created = co_await with_deadline(
+      AsyncBridge<SessionDescription, PeerConnectionError>::async_run(
+          executor_,
+          [this](auto cb) {
+            pc_->CreateAnswer(CreateAndSetLocalProxy::Create(weak_from_this(), std::move(cb)).get(),
+                              webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+          },
+          boost::asio::use_awaitable),
+      operation_timeout_);
+  store_template(key, created);
+  co_return created;
+}
+
+std::optional<std::string> PeerConnectionImpl::template_key(webrtc::SdpType type) const {
+  if (!description_templates_ || local_description_.get()) {
+    return std::nullopt;
+  }
+  auto state = signaling_state();
+  auto remote = remote_description_.get();
+  if (type == webrtc::SdpType::kOffer) {
+    if (state != SignalingState::Stable || remote) {
+      return std::nullopt;
+    }
+    return DescriptionTemplates::offer_key(has_data_channels_.load(std::memory_order_acquire));
+  }
+  if (state != SignalingState::HaveRemoteOffer || !remote) {
+    return std::nullopt;
+  }
+  return DescriptionTemplates::answer_key(remote.description->sdp);
+}
+
+std::optional<SessionDescription> PeerConnectionImpl::instantiate_template(
+    const std::optional<std::string>& key) const {
+  if (!key) {
+    return std::nullopt;
   }
+  return context_->description_templates().instantiate(*key);
+}
 
-  co_return co_await AsyncBridge<void, PeerConnectionError>::async_run(
-      executor_,
-      [this, sd = std::move(session_desc)](auto cb) mutable {
-        pc_->SetLocalDescription(std::move(sd), SetLocalDescriptionProxy::Create(std::move(cb)));
-      },
-      boost::asio::use_awaitable);
+void PeerConnectionImpl::store_template(
+    const std::optional<std::string>& key,
+    const Result<SessionDescription, PeerConnectionError>& created) {
+  if (key && created) {
+    context_->description_templates().store(*key, created.value());
+  }
+}
+
+PeerConnectionImpl::Task<void> PeerConnectionImpl::set_local_description(
+    const SessionDescription& sdp) {
+  return set_description<const SessionDescription&>(DescriptionTarget::Local, sdp);
 }
 
 PeerConnectionImpl::Task<void> PeerConnectionImpl::set_remote_description(
     const SessionDescription& sdp) {
+  return set_description<const SessionDescription&>(DescriptionTarget::Remote, sdp);
+}
+
+PeerConnectionImpl::Task<void> PeerConnectionImpl::set_local_description(SessionDescription&& sdp) {
+  return set_description<SessionDescription>(DescriptionTarget::Local, std::move(sdp));
+}
+
+PeerConnectionImpl::Task<void> PeerConnectionImpl::set_remote_description(
+    SessionDescription&& sdp) {
+  return set_description<SessionDescription>(DescriptionTarget::Remote, std::move(sdp));
+}
+
+template <typename Sdp>
+PeerConnectionImpl::Task<void> PeerConnectionImpl::set_description(DescriptionTarget target,
+                                                                   Sdp sdp) {
   auto sdp_type_res = webrtc::SdpTypeFromString(sdp.type);
   if (!sdp_type_res) {
     co_return Err(PeerConnectionError::InvalidSdp);
@@ -100,28 +290,97 @@ PeerConnectionImpl::Task<void> PeerConnectionImpl::set_remote_description(
     co_return Err(PeerConnectionError::InvalidSdp);
   }
 
-  co_return co_await AsyncBridge<void, PeerConnectionError>::async_run(
-      executor_,
-      [this, sd = std::move(session_desc)](auto cb) mutable {
-        pc_->SetRemoteDescription(std::move(sd), SetRemoteDescriptionProxy::Create(std::move(cb)));
-      },
-      boost::asio::use_awaitable);
+  auto pc = pc_;
+  if (!pc) {
+    co_return Err(PeerConnectionError::InvalidState);
+  }
+  co_return co_await with_deadline(
+      AsyncBridge<void, PeerConnectionError>::async_run(
+          executor_,
+          [pc = std::move(pc), target, sd = std::move(session_desc)](auto cb) mutable {
+            if (target == DescriptionTarget::Local) {
+              pc->SetLocalDescription(std::move(sd),
+                                      SetLocalDescriptionProxy::Create(std::move(cb)));
+            } else {
+              pc->SetRemoteDescription(std::move(sd),
+                                       SetRemoteDescriptionProxy::Create(std::move(cb)));
+            }
+          },
+          boost::asio::use_awaitable),
+      operation_timeout_);
+}
+
+void PeerConnectionImpl::set_created_local_description(
+    std::unique_ptr<webrtc::SessionDescriptionInterface> desc,
+    std::shared_ptr<const SessionDescription> serialized,
+    webrtc::scoped_refptr<webrtc::SetLocalDescriptionObserverInterface> observer) {
+  // WebRTC queues the operation behind the one that created desc, so the
+  // expectation stays until the observer reports back. A closed connection rejects it.
+  local_description_.expect(desc.get(), std::move(serialized));
+  signaling_pc_->SetLocalDescription(std::move(desc), std::move(observer));
+}
+
+void PeerConnectionImpl::created_local_description_applied() {
+  local_description_.expect(nullptr, nullptr);
 }
 
 std::optional<SessionDescription> PeerConnectionImpl::local_description() const {
-  if (!pc_ || !pc_->local_description()) return std::nullopt;
-  std::string sdp;
-  pc_->local_description()->ToString(&sdp);
-  return SessionDescription{.type = webrtc::SdpTypeToString(pc_->local_description()->GetType()),
-                            .sdp = sdp};
+  auto shared = local_description_.get();
+  if (!shared) return std::nullopt;
+  return *shared.description;
 }
 
 std::optional<SessionDescription> PeerConnectionImpl::remote_description() const {
-  if (!pc_ || !pc_->remote_description()) return std::nullopt;
-  std::string sdp;
-  pc_->remote_description()->ToString(&sdp);
-  return SessionDescription{.type = webrtc::SdpTypeToString(pc_->remote_description()->GetType()),
-                            .sdp = sdp};
+  auto shared = remote_description_.get();
+  if (!shared) return std::nullopt;
+  return *shared.description;
+}
+
+SharedSessionDescription PeerConnectionImpl::shared_local_description() const {
+  return local_description_.get();
+}
+
+SharedSessionDescription PeerConnectionImpl::shared_remote_description() const {
+  return remote_description_.get();
+}
+
+void PeerConnectionImpl::refresh_descriptions() {
+  local_description_.refresh(signaling_pc_->local_description());
+  remote_description_.refresh(signaling_pc_->remote_description());
+}
+
+void PeerConnectionImpl::DescriptionCache::refresh(
+    const webrtc::SessionDescriptionInterface* native) {
+  // A replacement is created while the current description is still alive, so a
+  // new description never shows up at the address of the cached one.
+  auto candidates = native ? count_candidates(*native) : 0;
+  if (native == native_ && candidates == candidates_) {
+    return;
+  }
+  native_ = native;
+  candidates_ = candidates;
+
+  std::shared_ptr<const SessionDescription> description;
+  if (native && native == expected_native_ && expected_) {
+    // Created by this connection and not changed since: reuse its serialized form.
+    description = std::exchange(expected_, nullptr);
+  } else if (native) {
+    std::string sdp;
+    native->ToString(&sdp);
+    description = std::make_shared<const SessionDescription>(SessionDescription{
+        .type = webrtc::SdpTypeToString(native->GetType()), .sdp = std::move(sdp)});
+  }
+  published_.update([&](const SharedSessionDescription& current) {
+    return SharedSessionDescription{.description = std::move(description),
+                                    .generation = current.generation + 1};
+  });
+}
+
+void PeerConnectionImpl::DescriptionCache::expect(
+    const webrtc::SessionDescriptionInterface* native,
+    std::shared_ptr<const SessionDescription> serialized) {
+  expected_native_ = native;
+  expected_ = std::move(serialized);
 }
 
 Expected<void> PeerConnectionImpl::add_ice_candidate(const IceCandidate& candidate) {
@@ -137,6 +396,95 @@ Expected<void> PeerConnectionImpl::add_ice_candidate(const IceCandidate& candida
   return Success();
 }
 
+PeerConnectionImpl::Task<void> PeerConnectionImpl::add_ice_candidates(
+    std::span<const IceCandidate> candidates) {
+  // Parsed here so that a malformed candidate fails the batch before any is applied.
+  std::vector<std::unique_ptr<webrtc::IceCandidateInterface>> parsed;
+  parsed.reserve(candidates.size());
+  for (const auto& candidate : candidates) {
+    if (candidate.candidate.empty()) {
+      continue;
+    }
+    webrtc::SdpParseError error;
+    std::unique_ptr<webrtc::IceCandidateInterface> native_candidate(webrtc::CreateIceCandidate(
+        candidate.sdp_mid, candidate.sdp_mline_index, candidate.candidate, &error));
+    if (!native_candidate) {
+      co_return Err(PeerConnectionError::InvalidArgument);
+    }
+    parsed.push_back(std::move(native_candidate));
+  }
+  if (parsed.empty()) {
+    co_return Success();
+  }
+  if (!pc_) {
+    co_return Err(PeerConnectionError::InvalidState);
+  }
+
+  co_return co_await with_deadline(
+      AsyncBridge<void, PeerConnectionError>::async_run(
+          executor_,
+          [this, parsed = std::move(parsed)](auto cb) mutable {
+            context_->signaling_thread()->PostTask(
+                [pc = pc_, parsed = std::move(parsed), cb = std::move(cb)]() mutable {
+                  add_candidates_on_signaling_thread(std::move(pc), std::move(parsed),
+                                                     std::move(cb));
+                });
+          },
+          boost::asio::use_awaitable),
+      operation_timeout_);
+}
+
+PeerConnectionImpl::Task<SessionDescription> PeerConnectionImpl::wait_ice_gathering_complete(
+    std::optional<std::chrono::milliseconds> timeout) {
+  // Gathering starts once a local description is applied.
+  if (!local_description_.get()) {
+    co_return Err(PeerConnectionError::InvalidState);
+  }
+  if (ice_gathering_state() != IceGatheringState::Complete) {
+    auto completed = co_await with_deadline(
+        AsyncBridge<void, PeerConnectionError>::async_run(
+            executor_, [this](auto cb) { add_gathering_waiter(std::move(cb)); },
+            boost::asio::use_awaitable),
+        timeout);
+    // Only the timeout returns a partial description; cancellation is reported.
+    if (!completed && completed.error() != PeerConnectionError::Timeout) {
+      co_return Err(completed.error());
+    }
+  }
+  auto local = local_description_.get();
+  if (!local) {
+    co_return Err(PeerConnectionError::InvalidState);
+  }
+  co_return *local.description;
+}
+
+void PeerConnectionImpl::add_gathering_waiter(GatheringWaiter waiter) {
+  {
+    std::lock_guard lock(gathering_mutex_);
+    if (ice_gathering_state() != IceGatheringState::Complete) {
+      // Waits that timed out or were cancelled are pruned when the next one registers,
+      // so continual gathering, which may never complete, does not accumulate them.
+      std::erase_if(gathering_waiters_,
+                    [](const GatheringWaiter& pending) { return pending.canceled(); });
+      gathering_waiters_.push_back(std::move(waiter));
+      return;
+    }
+  }
+  waiter(Success());
+}
+
+void PeerConnectionImpl::complete_gathering_waiters(Result<void, PeerConnectionError> result) {
+  std::vector<GatheringWaiter> waiters;
+  {
+    std::lock_guard lock(gathering_mutex_);
+    waiters.swap(gathering_waiters_);
+  }
+
+  for (auto& waiter : waiters) {
+    waiter(result);
+  }
+}
+
 Expected<std::shared_ptr<DataChannel>> PeerConnectionImpl::create_data_channel(
     const std::string& label, const DataChannelConfig& config) {
   webrtc::DataChannelInit init;
@@ -158,23 +506,41 @@ Expected<std::shared_ptr<DataChannel>> PeerConnectionImpl::create_data_channel(
     return Err(PeerConnectionError::InternalError);
   }
 
-  return std::shared_ptr<DataChannel>(
-      DataChannelImpl::Create(result.MoveValue(), shared_from_this()));
+  has_data_channels_.store(true, std::memory_order_release);
+  auto channel = DataChannelImpl::Create(result.MoveValue(), shared_from_this(), executor_,
+                                         event_delivery_);
+  channel->set_buffered_amount_thresholds(config.buffered_amount_high_threshold,
+                                          config.buffered_amount_low_threshold);
+  if (config.receive_queue) {
+    channel->enable_receive_queue(*config.receive_queue);
+  }
+  return std::shared_ptr<DataChannel>(std::move(channel));
 }
 
 SignalingState PeerConnectionImpl::signaling_state() const {
-  std::lock_guard lock(mutex_);
-  return cached_signaling_state_;
+  return signaling_state_.load(std::memory_order_acquire);
 }
 
 IceConnectionState PeerConnectionImpl::ice_connection_state() const {
-  std::lock_guard lock(mutex_);
-  return cached_ice_connection_state_;
+  return ice_connection_state_.load(std::memory_order_acquire);
 }
 
 IceGatheringState PeerConnectionImpl::ice_gathering_state() const {
-  std::lock_guard lock(mutex_);
-  return cached_ice_gathering_state_;
+  return ice_gathering_state_.load(std::memory_order_acquire);
+}
+
+DeliveryStats PeerConnectionImpl::delivery_stats() const {
+  return events_ ? events_->stats() : DeliveryStats{};
+}
+
+void PeerConnectionImpl::schedule_drain() {
+  boost::asio::post(*executor_, [weak = weak_from_this()]() {
+    if (auto self = weak.lock()) {
+      if (self->events_->drain()) {
+        self->schedule_drain();
+      }
+    }
+  });
 }
 
 void PeerConnectionImpl::close() {
@@ -182,71 +548,77 @@ void PeerConnectionImpl::close() {
     pc_->Close();
     pc_ = nullptr;
   }
+  complete_gathering_waiters(Err(PeerConnectionError::InvalidState));
 }
 
 void PeerConnectionImpl::handle_signaling_change(SignalingState new_state) {
-  {
-    std::lock_guard lock(mutex_);
-    cached_signaling_state_ = new_state;
-  }
-  signaling_state_event.emit(new_state);
+  // Applying a description is what moves the signaling state.
+  refresh_descriptions();
+  signaling_state_.store(new_state, std::memory_order_release);
+  deliver([this, new_state]() { signaling_state_event.emit(new_state); });
 }
 
 void PeerConnectionImpl::handle_ice_connection_change(IceConnectionState new_state) {
-  {
-    std::lock_guard lock(mutex_);
-    cached_ice_connection_state_ = new_state;
-  }
-  ice_connection_state_event.emit(new_state);
+  ice_connection_state_.store(new_state, std::memory_order_release);
+  deliver([this, new_state]() { ice_connection_state_event.emit(new_state); });
 }
 
 void PeerConnectionImpl::handle_ice_gathering_change(IceGatheringState new_state) {
-  {
-    std::lock_guard lock(mutex_);
-    cached_ice_gathering_state_ = new_state;
+  // Gathered candidates are part of the local description.
+  refresh_descriptions();
+  ice_gathering_state_.store(new_state, std::memory_order_release);
+  if (new_state == IceGatheringState::Complete) {
+    flush_ice_candidates(true);
+    complete_gathering_waiters(Success());
+  }
+  deliver([this, new_state]() { ice_gathering_state_event.emit(new_state); });
+}
+
+void PeerConnectionImpl::handle_ice_candidate(IceCandidate ice) {
+  refresh_descriptions();
+  if (events_) {
+    // The queued handler needs its own copy; the candidate itself goes to the batch.
+    deliver([this, ice]() { ice_candidate_event.emit(ice); });
+  } else {
+    ice_candidate_event.emit(ice);
+  }
+  if (ice_candidate_batch_window_.count() == 0) {
+    pending_ice_candidates_.push_back(std::move(ice));
+    flush_ice_candidates(false);
+  } else {
+    if (pending_ice_candidates_.empty()) {
+      context_->signaling_thread()->PostDelayedTask(
+          [weak = weak_from_this(), epoch = ice_batch_epoch_]() {
+            auto self = weak.lock();
+            if (self && self->ice_batch_epoch_ == epoch) {
+              self->flush_ice_candidates(false);
+            }
+          },
+          webrtc::TimeDelta::Millis(ice_candidate_batch_window_.count()));
+    }
+    pending_ice_candidates_.push_back(std::move(ice));
   }
 }
 
-void PeerConnectionImpl::handle_ice_candidate(const IceCandidate& ice) {
-  ice_candidate_event.emit(ice);
+void PeerConnectionImpl::flush_ice_candidates(bool end_of_candidates) {
+  ++ice_batch_epoch_;
+  if (pending_ice_candidates_.empty() && !end_of_candidates) {
+    return;
+  }
+  IceCandidateBatch batch{.candidates = std::exchange(pending_ice_candidates_, {}),
+                          .end_of_candidates = end_of_candidates};
+  deliver([this, batch = std::move(batch)]() { ice_candidates_event.emit(batch); });
 }
 
 void PeerConnectionImpl::handle_data_channel(std::shared_ptr<DataChannel> channel) {
-  data_channel_event.emit(channel);
+  deliver([this, channel = std::move(channel)]() { data_channel_event.emit(channel); });
 }
 
 Expected<std::shared_ptr<PeerConnectionImpl>> PeerConnectionImpl::Create(
-    std::optional<boost::asio::any_io_executor> executor, const PeerConnectionConfig& config) {
-  // Ensure SSL is initialized exactly once
-  static std::once_flag ssl_init_flag;
-  std::call_once(ssl_init_flag, []() { webrtc::InitializeSSL(); });
-
-  // Create all 3 threads (matching WebRTCApplication pattern)
-  auto network_thread = webrtc::Thread::CreateWithSocketServer();
-  auto worker_thread = webrtc::Thread::Create();
-  auto signaling_thread = webrtc::Thread::Create();
-
-  network_thread->Start();
-  worker_thread->Start();
-  signaling_thread->Start();
-
-  webrtc::PeerConnectionFactoryDependencies deps;
-  deps.network_thread = network_thread.get();
-  deps.worker_thread = worker_thread.get();
-  deps.signaling_thread = signaling_thread.get();
-  deps.audio_encoder_factory = webrtc::CreateBuiltinAudioEncoderFactory();
-  deps.audio_decoder_factory = webrtc::CreateBuiltinAudioDecoderFactory();
-  deps.video_encoder_factory = std::make_unique<webrtc::VideoEncoderFactoryTemplate<
-      webrtc::LibvpxVp8EncoderTemplateAdapter, webrtc::LibvpxVp9EncoderTemplateAdapter,
-      webrtc::OpenH264EncoderTemplateAdapter, webrtc::LibaomAv1EncoderTemplateAdapter>>();
-  deps.video_decoder_factory = std::make_unique<webrtc::VideoDecoderFactoryTemplate<
-      webrtc::LibvpxVp8DecoderTemplateAdapter, webrtc::LibvpxVp9DecoderTemplateAdapter,
-      webrtc::OpenH264DecoderTemplateAdapter, webrtc::Dav1dDecoderTemplateAdapter>>();
-
-  auto pc_factory = webrtc::CreateModularPeerConnectionFactory(std::move(deps));
-
-  if (!pc_factory) {
-    return Err(PeerConnectionError::InternalError);
+    std::shared_ptr<RtcContextImpl> context, std::optional<boost::asio::any_io_executor> executor,
+    const PeerConnectionConfig& config) {
+  if (config.event_delivery.mode == EventDelivery::Executor && !executor) {
+    return Err(PeerConnectionError::InvalidArgument);
   }
 
   webrtc::PeerConnectionInterface::RTCConfiguration rtc_config;
@@ -257,8 +629,21 @@ Expected<std::shared_ptr<PeerConnectionImpl>> PeerConnectionImpl::Create(
     ice_server.password = server.credential;
     rtc_config.servers.push_back(ice_server);
   }
+  if (auto applied = apply_ice_config(config.ice, rtc_config); !applied) {
+    return Err(applied.error());
+  }
+  if (config.description_templates) {
+    auto certificate = context->template_certificate();
+    if (!certificate) {
+      return Err(PeerConnectionError::InternalError);
+    }
+    rtc_config.certificates.push_back(std::move(certificate));
+  }
 
-  auto impl = std::shared_ptr<PeerConnectionImpl>(new PeerConnectionImpl(std::move(executor)));
+  auto shard = context->acquire_shard();
+  auto* pc_factory = context->factory(shard);
+  auto impl = std::shared_ptr<PeerConnectionImpl>(new PeerConnectionImpl(
+      std::move(context), shard, std::move(executor), config));
   impl->observer_proxy_ = std::make_unique<PeerConnectionObserverProxy>(impl);
 
   webrtc::PeerConnectionDependencies pc_deps(impl->observer_proxy_.get());
@@ -268,8 +653,6 @@ Expected<std::shared_ptr<PeerConnectionImpl>> PeerConnectionImpl::Create(
     return Err(PeerConnectionError::InternalError);
   }
 
-  impl->set_threads_and_factory(std::move(network_thread), std::move(worker_thread),
-                                std::move(signaling_thread), pc_factory);
   impl->set_pc(result.MoveValue());
   return impl;
 }
@@ -1,13 +1,25 @@
 #pragma once
 
 #include <api/peer_connection_interface.h>
-#include <rtc_base/thread.h>
 
+#include <atomic>
 #include <boost/asio/any_io_executor.hpp>
 #include <boost/asio/awaitable.hpp>
+#include <chrono>
+#include <cstdint>
+#include <librtc/errors/peer_connection_error.hpp>
 #include <librtc/peer_connection.hpp>
+#include <librtc/utils/async_bridge.hpp>
+#include <librtc/utils/atomic_snapshot.hpp>
+#include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "event_queue.hpp"
+#include "rtc_context_impl.hpp"
 
 namespace librtc {
 
@@ -17,23 +29,33 @@ class PeerConnectionImpl : public PeerConnection,
                            public std::enable_shared_from_this<PeerConnectionImpl> {
  public:
   static Expected<std::shared_ptr<PeerConnectionImpl>> Create(
-      std::optional<boost::asio::any_io_executor> executor, const PeerConnectionConfig& config);
+      std::shared_ptr<RtcContextImpl> context, std::optional<boost::asio::any_io_executor> executor,
+      const PeerConnectionConfig& config);
 
-  explicit PeerConnectionImpl(std::optional<boost::asio::any_io_executor> executor);
+  PeerConnectionImpl(std::shared_ptr<RtcContextImpl> context, std::size_t shard,
+                     std::optional<boost::asio::any_io_executor> executor,
+                     const PeerConnectionConfig& config);
 
   // Internal initialization
-  void set_threads_and_factory(
-      std::unique_ptr<webrtc::Thread> network_thread, std::unique_ptr<webrtc::Thread> worker_thread,
-      std::unique_ptr<webrtc::Thread> signaling_thread,
-      webrtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory);
   void set_pc(webrtc::scoped_refptr<webrtc::PeerConnectionInterface> pc);
 
+  const std::optional<boost::asio::any_io_executor>& executor() const {
+    return executor_;
+  }
+
+  const EventDeliveryConfig& event_delivery() const {
+    return event_delivery_;
+  }
+
   ~PeerConnectionImpl() override;
 
   // PeerConnection Interface Implementation
   Event<const IceCandidate&>& on_ice_candidate() override {
     return ice_candidate_event;
   }
+  Event<const IceCandidateBatch&>& on_ice_candidates() override {
+    return ice_candidates_event;
+  }
   Event<std::shared_ptr<DataChannel>>& on_data_channel() override {
     return data_channel_event;
   }
@@ -43,16 +65,28 @@ class PeerConnectionImpl : public PeerConnection,
   Event<SignalingState>& on_signaling_state_change() override {
     return signaling_state_event;
   }
+  Event<IceGatheringState>& on_ice_gathering_state_change() override {
+    return ice_gathering_state_event;
+  }
 
   Task<SessionDescription> create_offer() override;
   Task<SessionDescription> create_answer() override;
   Task<void> set_local_description(const SessionDescription& sdp) override;
   Task<void> set_remote_description(const SessionDescription& sdp) override;
+  Task<void> set_local_description(SessionDescription&& sdp) override;
+  Task<void> set_remote_description(SessionDescription&& sdp) override;
+  Task<SessionDescription> offer_and_set_local() override;
+  Task<SessionDescription> answer_and_set_local() override;
 
   std::optional<SessionDescription> local_description() const override;
   std::optional<SessionDescription> remote_description() const override;
+  SharedSessionDescription shared_local_description() const override;
+  SharedSessionDescription shared_remote_description() const override;
 
   Expected<void> add_ice_candidate(const IceCandidate& candidate) override;
+  Task<void> add_ice_candidates(std::span<const IceCandidate> candidates) override;
+  Task<SessionDescription> wait_ice_gathering_complete(
+      std::optional<std::chrono::milliseconds> timeout) override;
   Expected<std::shared_ptr<DataChannel>> create_data_channel(
       const std::string& label, const DataChannelConfig& config) override;
 
@@ -60,36 +94,130 @@ class PeerConnectionImpl : public PeerConnection,
   IceConnectionState ice_connection_state() const override;
   IceGatheringState ice_gathering_state() const override;
 
+  DeliveryStats delivery_stats() const override;
+
   void close() override;
 
   // Handlers for proxy
   void handle_signaling_change(SignalingState new_state);
   void handle_ice_connection_change(IceConnectionState new_state);
   void handle_ice_gathering_change(IceGatheringState new_state);
-  void handle_ice_candidate(const IceCandidate& ice);
+  void handle_ice_candidate(IceCandidate ice);
   void handle_data_channel(std::shared_ptr<DataChannel> channel);
+  // Applies a description created by offer_and_set_local/answer_and_set_local whose
+  // serialized form is already known. Signaling thread only.
+  void set_created_local_description(
+      std::unique_ptr<webrtc::SessionDescriptionInterface> desc,
+      std::shared_ptr<const SessionDescription> serialized,
+      webrtc::scoped_refptr<webrtc::SetLocalDescriptionObserverInterface> observer);
+  void created_local_description_applied();
 
   // Internal event sources
   EventSource<const IceCandidate&> ice_candidate_event;
+  EventSource<const IceCandidateBatch&> ice_candidates_event;
   EventSource<std::shared_ptr<DataChannel>> data_channel_event;
   EventSource<IceConnectionState> ice_connection_state_event;
   EventSource<SignalingState> signaling_state_event;
+  EventSource<IceGatheringState> ice_gathering_state_event;
 
  private:
+  enum class DescriptionTarget { Local, Remote };
+
+  // Completion of a suspended wait_ice_gathering_complete.
+  using GatheringWaiter = AsyncBridge<void, PeerConnectionError>::Completion;
+  void add_gathering_waiter(GatheringWaiter waiter);
+  void complete_gathering_waiters(Result<void, PeerConnectionError> result);
+
+  // Sdp is either `const SessionDescription&` or `SessionDescription`; the latter keeps
+  // the description in the coroutine frame.
+  template <typename Sdp>
+  Task<void> set_description(DescriptionTarget target, Sdp sdp);
+
+  // Key of the template the next description of this type can come from, or nullopt
+  // when templates are off or this is not the initial negotiation.
+  std::optional<std::string> template_key(webrtc::SdpType type) const;
+  std::optional<SessionDescription> instantiate_template(
+      const std::optional<std::string>& key) const;
+  void store_template(const std::optional<std::string>& key,
+                      const Result<SessionDescription, PeerConnectionError>& created);
+
+  // Runs emit on the calling WebRTC thread, or queues it for the executor.
+  template <typename F>
+  void deliver(F&& emit) {
+    if (!events_) {
+      emit();
+      return;
+    }
+    if (events_->push(std::forward<F>(emit))) {
+      schedule_drain();
+    }
+  }
+  void schedule_drain();
+  // Re-reads the native descriptions. Signaling thread only.
+  void refresh_descriptions();
+  // Delivers the pending candidates as one batch. Signaling thread only.
+  void flush_ice_candidates(bool end_of_candidates);
+
+  // Serialized copy of one native description. refresh() runs on the signaling thread
+  // and only re-serializes when the description was replaced or gained candidates.
+  class DescriptionCache {
+   public:
+    void refresh(const webrtc::SessionDescriptionInterface* native);
+    // The next refresh() that finds native publishes serialized instead of calling
+    // ToString. Cleared with expect(nullptr, nullptr) once native has been applied.
+    void expect(const webrtc::SessionDescriptionInterface* native,
+                std::shared_ptr<const SessionDescription> serialized);
+    SharedSessionDescription get() const {
+      return *published_.read();
+    }
+
+   private:
+    const webrtc::SessionDescriptionInterface* native_ = nullptr;
+    std::size_t candidates_ = 0;
+    const webrtc::SessionDescriptionInterface* expected_native_ = nullptr;
+    std::shared_ptr<const SessionDescription> expected_;
+    AtomicSnapshot<SharedSessionDescription> published_;
+  };
+
   // Destruction order matters! Destroyed in reverse order of declaration.
-  std::unique_ptr<webrtc::Thread> network_thread_;
-  std::unique_ptr<webrtc::Thread> worker_thread_;
-  std::unique_ptr<webrtc::Thread> signaling_thread_;
-  webrtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> pc_factory_;
+  // context_ is the lifetime anchor for the shared threads and factory, so it
+  // must outlive pc_.
+  std::shared_ptr<RtcContextImpl> context_;
+  std::size_t shard_;
   webrtc::scoped_refptr<webrtc::PeerConnectionInterface> pc_;
+  // The same connection for code running on the signaling thread. close() clears pc_
+  // on the caller's thread, so the signaling thread never reads pc_; this one is set
+  // once by set_pc and released only on destruction.
+  webrtc::scoped_refptr<webrtc::PeerConnectionInterface> signaling_pc_;
 
   std::unique_ptr<PeerConnectionObserverProxy> observer_proxy_;
   std::optional<boost::asio::any_io_executor> executor_;
-  mutable std::mutex mutex_;
-
-  SignalingState cached_signaling_state_ = SignalingState::Stable;
-  IceConnectionState cached_ice_connection_state_ = IceConnectionState::New;
-  IceGatheringState cached_ice_gathering_state_ = IceGatheringState::New;
+  EventDeliveryConfig event_delivery_;
+  std::optional<std::chrono::milliseconds> operation_timeout_;
+  bool description_templates_;
+  std::chrono::milliseconds ice_candidate_batch_window_;
+  // Part of the offer template key; set once the first data channel exists.
+  std::atomic<bool> has_data_channels_{false};
+  std::unique_ptr<EventQueue> events_;
+
+  // Published by the observer callbacks on the signaling thread, where reading the
+  // native connection does not hop threads, so the getters never block.
+  std::atomic<SignalingState> signaling_state_{SignalingState::Stable};
+  std::atomic<IceConnectionState> ice_connection_state_{IceConnectionState::New};
+  std::atomic<IceGatheringState> ice_gathering_state_{IceGatheringState::New};
+  DescriptionCache local_description_;
+  DescriptionCache remote_description_;
+
+  // Candidates collected for the current batch window. ice_batch_epoch_ grows with
+  // every flush, so a window timer that fires after an early flush does nothing.
+  // Signaling thread only.
+  std::vector<IceCandidate> pending_ice_candidates_;
+  std::uint64_t ice_batch_epoch_ = 0;
+
+  // Guards gathering_waiters_. Waiters are registered after checking
+  // ice_gathering_state_ under it, and taken from it after Complete is published.
+  std::mutex gathering_mutex_;
+  std::vector<GatheringWaiter> gathering_waiters_;
 };
 
 }  // namespace librtc
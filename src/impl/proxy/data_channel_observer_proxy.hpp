@@ -24,9 +24,9 @@ class DataChannelObserverProxy : public webrtc::DataChannelObserver {
     }
   }
 
-  void OnBufferedAmountChange(uint64_t previous_amount) override {
+  void OnBufferedAmountChange(uint64_t sent_data_size) override {
     if (auto locked = impl_.lock()) {
-      locked->handle_buffered_amount_change(previous_amount);
+      locked->handle_buffered_amount_change(sent_data_size);
     }
   }
 
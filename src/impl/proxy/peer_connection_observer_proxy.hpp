@@ -36,7 +36,7 @@ class PeerConnectionObserverProxy : public webrtc::PeerConnectionObserver {
     if (auto locked = impl_.lock()) {
       std::string candidate_str;
       candidate->ToString(&candidate_str);
-      locked->handle_ice_candidate({.candidate = candidate_str,
+      locked->handle_ice_candidate({.candidate = std::move(candidate_str),
                                     .sdp_mid = candidate->sdp_mid(),
                                     .sdp_mline_index = candidate->sdp_mline_index()});
     }
@@ -44,7 +44,8 @@ class PeerConnectionObserverProxy : public webrtc::PeerConnectionObserver {
 
   void OnDataChannel(webrtc::scoped_refptr<webrtc::DataChannelInterface> channel) override {
     if (auto locked = impl_.lock()) {
-      locked->handle_data_channel(DataChannelImpl::Create(channel, locked));
+      locked->handle_data_channel(DataChannelImpl::Create(channel, locked, locked->executor(),
+                                                          locked->event_delivery()));
     }
   }
 
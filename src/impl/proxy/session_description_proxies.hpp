@@ -6,12 +6,16 @@
 #include <api/scoped_refptr.h>
 #include <rtc_base/ref_counted_object.h>
 
-#include <functional>
+#include <cstddef>
 #include <librtc/peer_connection.hpp>
+#include <librtc/utils/async_bridge.hpp>
 #include <librtc/utils/expected.hpp>
+#include <librtc/utils/recycling_allocator.hpp>
 #include <memory>
 #include <string>
 
+#include "impl/peer_connection_impl.hpp"
+
 namespace librtc {
 namespace {
 
@@ -48,9 +52,21 @@ PeerConnectionError convert_rtc_error(webrtc::RTCError error) {
 
 }  // namespace
 
-class CreateDescriptionProxy : public webrtc::CreateSessionDescriptionObserver {
+// Observers are created per operation and released by WebRTC on the signaling
+// thread; allocating them from the recycling pool keeps negotiation off malloc.
+struct PooledObserver {
+  static void* operator new(std::size_t size) {
+    return detail::RecyclingPool::allocate(size);
+  }
+  static void operator delete(void* p) noexcept {
+    detail::RecyclingPool::deallocate(p);
+  }
+};
+
+class CreateDescriptionProxy : public webrtc::CreateSessionDescriptionObserver,
+                               public PooledObserver {
  public:
-  using Callback = std::function<void(Result<SessionDescription, PeerConnectionError>)>;
+  using Callback = AsyncBridge<SessionDescription, PeerConnectionError>::Completion;
 
   static webrtc::scoped_refptr<CreateDescriptionProxy> Create(Callback cb) {
     return webrtc::scoped_refptr<CreateDescriptionProxy>(
@@ -60,9 +76,12 @@ class CreateDescriptionProxy : public webrtc::CreateSessionDescriptionObserver {
   explicit CreateDescriptionProxy(Callback cb) : cb_(std::move(cb)) {}
 
   void OnSuccess(webrtc::SessionDescriptionInterface* desc) override {
+    // The observer owns desc.
+    std::unique_ptr<webrtc::SessionDescriptionInterface> owned(desc);
     std::string sdp;
-    desc->ToString(&sdp);
-    cb_(SessionDescription{.type = webrtc::SdpTypeToString(desc->GetType()), .sdp = sdp});
+    owned->ToString(&sdp);
+    cb_(SessionDescription{.type = webrtc::SdpTypeToString(owned->GetType()),
+                           .sdp = std::move(sdp)});
   }
 
   void OnFailure(webrtc::RTCError error) override {
@@ -76,9 +95,69 @@ class CreateDescriptionProxy : public webrtc::CreateSessionDescriptionObserver {
   Callback cb_;
 };
 
-class SetLocalDescriptionProxy : public webrtc::SetLocalDescriptionObserverInterface {
+// Creates a description and applies it as the local one from the same signaling-thread
+// callback, so the SDP is serialized once and never parsed back.
+class CreateAndSetLocalProxy : public webrtc::CreateSessionDescriptionObserver,
+                               public webrtc::SetLocalDescriptionObserverInterface,
+                               public PooledObserver {
+ public:
+  using Callback = AsyncBridge<SessionDescription, PeerConnectionError>::Completion;
+
+  // Both observer bases declare AddRef/Release, so the reference has to name the
+  // RefCountedObject that implements them.
+  static webrtc::scoped_refptr<webrtc::RefCountedObject<CreateAndSetLocalProxy>> Create(
+      std::weak_ptr<PeerConnectionImpl> impl, Callback cb) {
+    return webrtc::scoped_refptr<webrtc::RefCountedObject<CreateAndSetLocalProxy>>(
+        new webrtc::RefCountedObject<CreateAndSetLocalProxy>(std::move(impl), std::move(cb)));
+  }
+
+  CreateAndSetLocalProxy(std::weak_ptr<PeerConnectionImpl> impl, Callback cb)
+      : impl_(std::move(impl)), cb_(std::move(cb)) {}
+
+  void OnSuccess(webrtc::SessionDescriptionInterface* desc) override {
+    std::unique_ptr<webrtc::SessionDescriptionInterface> owned(desc);
+    auto impl = impl_.lock();
+    if (!impl) {
+      cb_(Err(PeerConnectionError::InvalidState));
+      return;
+    }
+    std::string sdp;
+    owned->ToString(&sdp);
+    description_ = std::make_shared<const SessionDescription>(SessionDescription{
+        .type = webrtc::SdpTypeToString(owned->GetType()), .sdp = std::move(sdp)});
+    impl->set_created_local_description(
+        std::move(owned), description_,
+        webrtc::scoped_refptr<webrtc::SetLocalDescriptionObserverInterface>(this));
+  }
+
+  void OnFailure(webrtc::RTCError error) override {
+    cb_(Err(convert_rtc_error(error)));
+  }
+
+  void OnSetLocalDescriptionComplete(webrtc::RTCError error) override {
+    if (auto impl = impl_.lock()) {
+      impl->created_local_description_applied();
+    }
+    if (error.ok()) {
+      cb_(SessionDescription(*description_));
+    } else {
+      cb_(Err(convert_rtc_error(error)));
+    }
+  }
+
+ protected:
+  ~CreateAndSetLocalProxy() override = default;
+
+ private:
+  std::weak_ptr<PeerConnectionImpl> impl_;
+  Callback cb_;
+  std::shared_ptr<const SessionDescription> description_;
+};
+
+class SetLocalDescriptionProxy : public webrtc::SetLocalDescriptionObserverInterface,
+                                 public PooledObserver {
  public:
-  using Callback = std::function<void(Result<void, PeerConnectionError>)>;
+  using Callback = AsyncBridge<void, PeerConnectionError>::Completion;
 
   static webrtc::scoped_refptr<SetLocalDescriptionProxy> Create(Callback cb) {
     return webrtc::scoped_refptr<SetLocalDescriptionProxy>(
@@ -102,9 +181,10 @@ class SetLocalDescriptionProxy : public webrtc::SetLocalDescriptionObserverInter
   Callback cb_;
 };
 
-class SetRemoteDescriptionProxy : public webrtc::SetRemoteDescriptionObserverInterface {
+class SetRemoteDescriptionProxy : public webrtc::SetRemoteDescriptionObserverInterface,
+                                  public PooledObserver {
  public:
-  using Callback = std::function<void(Result<void, PeerConnectionError>)>;
+  using Callback = AsyncBridge<void, PeerConnectionError>::Completion;
 
   static webrtc::scoped_refptr<SetRemoteDescriptionProxy> Create(Callback cb) {
     return webrtc::scoped_refptr<SetRemoteDescriptionProxy>(
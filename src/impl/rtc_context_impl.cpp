@@ -0,0 +1,244 @@
+#include "rtc_context_impl.hpp"
+
+#include <api/audio_codecs/builtin_audio_decoder_factory.h>
+#include <api/audio_codecs/builtin_audio_encoder_factory.h>
+#include <api/create_peerconnection_factory.h>
+#include <api/video_codecs/video_decoder_factory_template.h>
+#include <api/video_codecs/video_decoder_factory_template_dav1d_adapter.h>
+#include <api/video_codecs/video_decoder_factory_template_libvpx_vp8_adapter.h>
+#include <api/video_codecs/video_decoder_factory_template_libvpx_vp9_adapter.h>
+#include <api/video_codecs/video_decoder_factory_template_open_h264_adapter.h>
+#include <api/video_codecs/video_encoder_factory_template.h>
+#include <api/video_codecs/video_encoder_factory_template_libaom_av1_adapter.h>
+#include <api/video_codecs/video_encoder_factory_template_libvpx_vp8_adapter.h>
+#include <api/video_codecs/video_encoder_factory_template_libvpx_vp9_adapter.h>
+#include <api/video_codecs/video_encoder_factory_template_open_h264_adapter.h>
+#include <rtc_base/rtc_certificate_generator.h>
+#include <rtc_base/ssl_adapter.h>
+#include <rtc_base/ssl_identity.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <librtc/errors/peer_connection_error.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace librtc {
+namespace {
+
+// CPUs this process may run on: the affinity mask, which also reflects cgroup cpusets,
+// or all hardware threads where that is not available.
+std::vector<int> usable_cpus() {
+  std::vector<int> cpus;
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    auto count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned cpu = 0; cpu < count; ++cpu) {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+  }
+  return cpus;
+}
+
+void add_media_dependencies(webrtc::PeerConnectionFactoryDependencies& deps) {
+  deps.audio_encoder_factory = webrtc::CreateBuiltinAudioEncoderFactory();
+  deps.audio_decoder_factory = webrtc::CreateBuiltinAudioDecoderFactory();
+  deps.video_encoder_factory = std::make_unique<webrtc::VideoEncoderFactoryTemplate<
+      webrtc::LibvpxVp8EncoderTemplateAdapter, webrtc::LibvpxVp9EncoderTemplateAdapter,
+      webrtc::OpenH264EncoderTemplateAdapter, webrtc::LibaomAv1EncoderTemplateAdapter>>();
+  deps.video_decoder_factory = std::make_unique<webrtc::VideoDecoderFactoryTemplate<
+      webrtc::LibvpxVp8DecoderTemplateAdapter, webrtc::LibvpxVp9DecoderTemplateAdapter,
+      webrtc::OpenH264DecoderTemplateAdapter, webrtc::Dav1dDecoderTemplateAdapter>>();
+}
+
+bool has_socket_options(const SocketOptions& options) {
+  return options.receive_buffer_size || options.send_buffer_size || options.dscp;
+}
+
+bool valid_socket_options(const SocketOptions& options) {
+  return options.receive_buffer_size.value_or(1) > 0 && options.send_buffer_size.value_or(1) > 0 &&
+         options.dscp.value_or(0) >= 0 && options.dscp.value_or(0) <= 63;
+}
+
+// Must be called on the thread being pinned. Returns false if the OS refused.
+bool pin_current_thread(int cpu) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
+RtcContextImpl::~RtcContextImpl() {
+  // Tear down every shard (factory first, then its threads) while the shared
+  // signaling thread is still running.
+  shards_.clear();
+}
+
+std::size_t RtcContextImpl::peer_connection_count() const {
+  std::size_t total = 0;
+  for (const auto& shard : shards_) {
+    total += shard->peer_connections.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+std::size_t RtcContextImpl::shard_count() const {
+  return shards_.size();
+}
+
+std::vector<ShardLoad> RtcContextImpl::shard_loads() const {
+  std::vector<ShardLoad> loads;
+  loads.reserve(shards_.size());
+  for (std::size_t i = 0; i < shards_.size(); ++i) {
+    const auto& shard = *shards_[i];
+    loads.push_back({.index = i,
+                     .peer_connections = shard.peer_connections.load(std::memory_order_relaxed),
+                     .cpu = shard.cpu});
+  }
+  return loads;
+}
+
+std::size_t RtcContextImpl::acquire_shard() {
+  // Least-loaded placement. Two concurrent creations may pick the same shard;
+  // the imbalance is bounded by the number of racing callers.
+  std::size_t best = 0;
+  std::size_t best_load = shards_[0]->peer_connections.load(std::memory_order_relaxed);
+  for (std::size_t i = 1; i < shards_.size() && best_load > 0; ++i) {
+    auto load = shards_[i]->peer_connections.load(std::memory_order_relaxed);
+    if (load < best_load) {
+      best = i;
+      best_load = load;
+    }
+  }
+  shards_[best]->peer_connections.fetch_add(1, std::memory_order_relaxed);
+  return best;
+}
+
+void RtcContextImpl::release_shard(std::size_t shard) {
+  shards_[shard]->peer_connections.fetch_sub(1, std::memory_order_relaxed);
+}
+
+webrtc::scoped_refptr<webrtc::RTCCertificate> RtcContextImpl::template_certificate() {
+  std::lock_guard lock(certificate_mutex_);
+  if (!template_certificate_) {
+    // The same ECDSA key WebRTC would otherwise generate for every connection.
+    template_certificate_ = webrtc::RTCCertificateGenerator::GenerateCertificate(
+        webrtc::KeyParams::ECDSA(), std::nullopt);
+  }
+  return template_certificate_;
+}
+
+SocketStats RtcContextImpl::socket_stats() const {
+  return socket_stats_.snapshot();
+}
+
+std::unique_ptr<RtcContextImpl::Shard> RtcContextImpl::create_shard(
+    std::size_t index, const RtcContextConfig& config, const std::vector<int>& cpus,
+    webrtc::Thread* signaling_thread, ShardNetwork* network,
+    TunedPacketSocketFactory::Stats* socket_stats) {
+  auto shard = std::make_unique<Shard>();
+  shard->network_thread = network ? network->create_network_thread(index)
+                                  : webrtc::Thread::CreateWithSocketServer();
+  shard->worker_thread = webrtc::Thread::Create();
+
+  auto suffix = std::to_string(index);
+  shard->network_thread->SetName(config.thread_name_prefix + "-net-" + suffix, nullptr);
+  shard->worker_thread->SetName(config.thread_name_prefix + "-worker-" + suffix, nullptr);
+
+  shard->network_thread->Start();
+  shard->worker_thread->Start();
+
+  if (config.pin_shards && !cpus.empty()) {
+    int cpu = cpus[index % cpus.size()];
+    auto pin = [cpu]() { return pin_current_thread(cpu); };
+    bool network_pinned = shard->network_thread->BlockingCall(pin);
+    bool worker_pinned = shard->worker_thread->BlockingCall(pin);
+    // Only report a pin that took effect on both threads.
+    if (network_pinned && worker_pinned) {
+      shard->cpu = cpu;
+    }
+  }
+
+  webrtc::PeerConnectionFactoryDependencies deps;
+  deps.network_thread = shard->network_thread.get();
+  deps.worker_thread = shard->worker_thread.get();
+  deps.signaling_thread = signaling_thread;
+  if (network) {
+    network->add_dependencies(shard->network_thread.get(), deps);
+  }
+  if (has_socket_options(config.socket_options)) {
+    deps.packet_socket_factory = std::make_unique<TunedPacketSocketFactory>(
+        shard->network_thread->socketserver(), config.socket_options, socket_stats);
+  }
+  if (config.profile == FactoryProfile::Full) {
+    add_media_dependencies(deps);
+  } else {
+    // No media factory and no audio device module: WebRTC runs with a null media
+    // engine and never probes the platform audio devices.
+    deps.media_factory = nullptr;
+    deps.adm = nullptr;
+  }
+
+  shard->pc_factory = webrtc::CreateModularPeerConnectionFactory(std::move(deps));
+  if (!shard->pc_factory) {
+    return nullptr;
+  }
+  return shard;
+}
+
+Expected<std::shared_ptr<RtcContextImpl>> RtcContextImpl::Create(
+    const RtcContextConfig& config, std::shared_ptr<ShardNetwork> network) {
+  // Ensure SSL is initialized exactly once
+  static std::once_flag ssl_init_flag;
+  std::call_once(ssl_init_flag, []() { webrtc::InitializeSSL(); });
+
+  if (!valid_socket_options(config.socket_options)) {
+    return Err(PeerConnectionError::InvalidArgument);
+  }
+
+  auto impl = std::make_shared<RtcContextImpl>();
+  impl->network_ = std::move(network);
+
+  // One signaling thread is shared by all shards; the network/worker pairs carry
+  // the SCTP/DTLS load and are the ones that need to scale.
+  impl->signaling_thread_ = webrtc::Thread::Create();
+  impl->signaling_thread_->SetName(config.thread_name_prefix + "-signaling", nullptr);
+  impl->signaling_thread_->Start();
+
+  auto cpus = usable_cpus();
+  auto shard_count = config.shard_count == 0 ? cpus.size() : config.shard_count;
+  impl->shards_.reserve(shard_count);
+  for (std::size_t i = 0; i < shard_count; ++i) {
+    auto shard = create_shard(i, config, cpus, impl->signaling_thread_.get(),
+                              impl->network_.get(), &impl->socket_stats_);
+    if (!shard) {
+      return Err(PeerConnectionError::InternalError);
+    }
+    impl->shards_.push_back(std::move(shard));
+  }
+
+  return impl;
+}
+
+}  // namespace librtc
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <api/peer_connection_interface.h>
+#include <rtc_base/rtc_certificate.h>
+#include <rtc_base/thread.h>
+
+#include <atomic>
+#include <librtc/rtc_context.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "description_templates.hpp"
+#include "tuned_packet_socket_factory.hpp"
+
+namespace librtc {
+
+/**
+ * Supplies the network side of every shard. Without one, a shard gets a thread with
+ * a physical socket server and WebRTC's default network manager; librtc::testing
+ * plugs in a virtual network instead.
+ */
+class ShardNetwork {
+ public:
+  virtual ~ShardNetwork() = default;
+
+  // Returns the network thread of shard \p index, not started yet.
+  virtual std::unique_ptr<webrtc::Thread> create_network_thread(std::size_t index) = 0;
+  // Adds the socket factory and network manager matching \p network_thread.
+  virtual void add_dependencies(webrtc::Thread* network_thread,
+                                webrtc::PeerConnectionFactoryDependencies& deps) = 0;
+};
+
+class RtcContextImpl : public RtcContext, public std::enable_shared_from_this<RtcContextImpl> {
+ public:
+  static Expected<std::shared_ptr<RtcContextImpl>> Create(
+      const RtcContextConfig& config, std::shared_ptr<ShardNetwork> network = nullptr);
+
+  RtcContextImpl() = default;
+  ~RtcContextImpl() override;
+
+  // RtcContext Interface Implementation
+  std::size_t peer_connection_count() const override;
+  std::size_t shard_count() const override;
+  std::vector<ShardLoad> shard_loads() const override;
+  SocketStats socket_stats() const override;
+
+  // Internal accessors used by PeerConnectionImpl
+  webrtc::PeerConnectionFactoryInterface* factory(std::size_t shard) const {
+    return shards_[shard]->pc_factory.get();
+  }
+  webrtc::Thread* signaling_thread() const {
+    return signaling_thread_.get();
+  }
+
+  // Places a new PeerConnection on the least-loaded shard and returns its index.
+  std::size_t acquire_shard();
+  void release_shard(std::size_t shard);
+
+  // Certificate of every connection that uses description templates, so that their
+  // descriptions share one fingerprint. Generated on first use; null if that fails.
+  webrtc::scoped_refptr<webrtc::RTCCertificate> template_certificate();
+  DescriptionTemplates& description_templates() {
+    return description_templates_;
+  }
+
+ private:
+  struct Shard {
+    // Destruction order matters! The factory must go away before its threads.
+    std::unique_ptr<webrtc::Thread> network_thread;
+    std::unique_ptr<webrtc::Thread> worker_thread;
+    webrtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> pc_factory;
+    std::optional<int> cpu;
+    std::atomic<std::size_t> peer_connections{0};
+  };
+
+  static std::unique_ptr<Shard> create_shard(std::size_t index, const RtcContextConfig& config,
+                                             const std::vector<int>& cpus,
+                                             webrtc::Thread* signaling_thread,
+                                             ShardNetwork* network,
+                                             TunedPacketSocketFactory::Stats* socket_stats);
+
+  // Destruction order matters! Destroyed in reverse order of declaration:
+  // the shards' threads and socket factories may belong to network_,
+  std::shared_ptr<ShardNetwork> network_;
+  // the shards' socket factories report into socket_stats_.
+  TunedPacketSocketFactory::Stats socket_stats_;
+  // every shard's factory must be gone before the shared signaling thread stops.
+  std::unique_ptr<webrtc::Thread> signaling_thread_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::mutex certificate_mutex_;
+  webrtc::scoped_refptr<webrtc::RTCCertificate> template_certificate_;
+  DescriptionTemplates description_templates_;
+};
+
+}  // namespace librtc
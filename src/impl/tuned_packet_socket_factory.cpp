@@ -0,0 +1,74 @@
+#include "tuned_packet_socket_factory.hpp"
+
+#include <rtc_base/socket.h>
+
+namespace librtc {
+namespace {
+
+std::optional<int> load(const std::atomic<int>& value, int unset) {
+  auto loaded = value.load(std::memory_order_relaxed);
+  return loaded == unset ? std::nullopt : std::optional<int>(loaded);
+}
+
+}  // namespace
+
+SocketStats TunedPacketSocketFactory::Stats::snapshot() const {
+  return SocketStats{.sockets = sockets_.load(std::memory_order_relaxed),
+                     .failures = failures_.load(std::memory_order_relaxed),
+                     .receive_buffer_size = load(receive_buffer_size_, kUnset),
+                     .send_buffer_size = load(send_buffer_size_, kUnset),
+                     .dscp = load(dscp_, kUnset)};
+}
+
+TunedPacketSocketFactory::TunedPacketSocketFactory(webrtc::SocketFactory* socket_factory,
+                                                   const SocketOptions& options, Stats* stats)
+    : webrtc::BasicPacketSocketFactory(socket_factory), options_(options), stats_(stats) {}
+
+webrtc::AsyncPacketSocket* TunedPacketSocketFactory::CreateUdpSocket(
+    const webrtc::SocketAddress& address, uint16_t min_port, uint16_t max_port) {
+  return tune(webrtc::BasicPacketSocketFactory::CreateUdpSocket(address, min_port, max_port));
+}
+
+webrtc::AsyncPacketSocket* TunedPacketSocketFactory::CreateClientTcpSocket(
+    const webrtc::SocketAddress& local_address, const webrtc::SocketAddress& remote_address,
+    const webrtc::PacketSocketTcpOptions& tcp_options) {
+  return tune(webrtc::BasicPacketSocketFactory::CreateClientTcpSocket(local_address,
+                                                                      remote_address, tcp_options));
+}
+
+webrtc::AsyncPacketSocket* TunedPacketSocketFactory::tune(webrtc::AsyncPacketSocket* socket) {
+  if (!socket) {
+    return nullptr;
+  }
+
+  std::size_t failures = 0;
+  // Sets opt and publishes the value the socket reports back, which for buffer sizes
+  // is the kernel-clamped one.
+  auto apply = [&](webrtc::Socket::Option opt, std::optional<int> value,
+                   std::atomic<int>& effective, bool read_back) {
+    if (!value) {
+      return;
+    }
+    if (socket->SetOption(opt, *value) != 0) {
+      ++failures;
+      return;
+    }
+    int current = *value;
+    if (read_back && socket->GetOption(opt, &current) != 0) {
+      current = *value;
+    }
+    effective.store(current, std::memory_order_relaxed);
+  };
+  apply(webrtc::Socket::OPT_RCVBUF, options_.receive_buffer_size, stats_->receive_buffer_size_,
+        true);
+  apply(webrtc::Socket::OPT_SNDBUF, options_.send_buffer_size, stats_->send_buffer_size_, true);
+  // IP_TOS carries the DSCP shifted into the upper six bits, so the configured value is
+  // reported instead of reading it back.
+  apply(webrtc::Socket::OPT_DSCP, options_.dscp, stats_->dscp_, false);
+
+  stats_->sockets_.fetch_add(1, std::memory_order_relaxed);
+  stats_->failures_.fetch_add(failures, std::memory_order_relaxed);
+  return socket;
+}
+
+}  // namespace librtc
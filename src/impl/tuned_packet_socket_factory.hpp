@@ -0,0 +1,54 @@
+#pragma once
+
+#include <api/packet_socket_factory.h>
+#include <p2p/base/basic_packet_socket_factory.h>
+#include <rtc_base/async_packet_socket.h>
+#include <rtc_base/socket_address.h>
+#include <rtc_base/socket_factory.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <librtc/rtc_context.hpp>
+
+namespace librtc {
+
+// Packet socket factory of a shard's network thread. Applies SocketOptions to every
+// UDP and client TCP socket it creates and records the values in effect.
+class TunedPacketSocketFactory : public webrtc::BasicPacketSocketFactory {
+ public:
+  // Shared by the factories of all shards of a context.
+  class Stats {
+   public:
+    SocketStats snapshot() const;
+
+   private:
+    friend class TunedPacketSocketFactory;
+
+    static constexpr int kUnset = -1;
+
+    std::atomic<std::size_t> sockets_{0};
+    std::atomic<std::size_t> failures_{0};
+    std::atomic<int> receive_buffer_size_{kUnset};
+    std::atomic<int> send_buffer_size_{kUnset};
+    std::atomic<int> dscp_{kUnset};
+  };
+
+  // stats must outlive the factory.
+  TunedPacketSocketFactory(webrtc::SocketFactory* socket_factory, const SocketOptions& options,
+                           Stats* stats);
+
+  webrtc::AsyncPacketSocket* CreateUdpSocket(const webrtc::SocketAddress& address,
+                                             uint16_t min_port, uint16_t max_port) override;
+  webrtc::AsyncPacketSocket* CreateClientTcpSocket(
+      const webrtc::SocketAddress& local_address, const webrtc::SocketAddress& remote_address,
+      const webrtc::PacketSocketTcpOptions& tcp_options) override;
+
+ private:
+  webrtc::AsyncPacketSocket* tune(webrtc::AsyncPacketSocket* socket);
+
+  SocketOptions options_;
+  Stats* stats_;
+};
+
+}  // namespace librtc
@@ -1,12 +1,21 @@
 #include <librtc/peer_connection.hpp>
 
+#include <librtc/errors/peer_connection_error.hpp>
+
 #include "impl/peer_connection_impl.hpp"
+#include "impl/rtc_context_impl.hpp"
 
 namespace librtc {
 
 Expected<std::shared_ptr<PeerConnection>> PeerConnection::Create(
-    std::optional<boost::asio::any_io_executor> executor, const PeerConnectionConfig& config) {
-  auto impl_result = PeerConnectionImpl::Create(std::move(executor), config);
+    std::shared_ptr<RtcContext> context, std::optional<boost::asio::any_io_executor> executor,
+    const PeerConnectionConfig& config) {
+  if (!context) {
+    return Err(PeerConnectionError::InvalidArgument);
+  }
+
+  auto impl_result = PeerConnectionImpl::Create(
+      std::static_pointer_cast<RtcContextImpl>(std::move(context)), std::move(executor), config);
 
   if (!impl_result) {
     return Err(impl_result.error());
@@ -0,0 +1,17 @@
+#include <librtc/rtc_context.hpp>
+
+#include "impl/rtc_context_impl.hpp"
+
+namespace librtc {
+
+Expected<std::shared_ptr<RtcContext>> RtcContext::Create(const RtcContextConfig& config) {
+  auto impl_result = RtcContextImpl::Create(config);
+
+  if (!impl_result) {
+    return Err(impl_result.error());
+  }
+
+  return std::shared_ptr<RtcContext>(impl_result.value());
+}
+
+}  // namespace librtc
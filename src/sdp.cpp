@@ -0,0 +1,269 @@
+#include <charconv>
+#include <librtc/sdp.hpp>
+
+namespace librtc {
+namespace {
+
+constexpr std::string_view kLineEnd = "\r\n";
+
+// Offset of the first m= line at or after from, or npos.
+std::size_t find_media_line(std::string_view sdp, std::size_t from) {
+  if (from == 0 && sdp.starts_with("m=")) {
+    return 0;
+  }
+  auto pos = sdp.find("\nm=", from == 0 ? 0 : from - 1);
+  return pos == std::string_view::npos ? pos : pos + 1;
+}
+
+// Field at index (counting from 0) of a space-separated value.
+std::optional<std::string_view> field(std::string_view value, std::size_t index) {
+  for (std::size_t i = 0; i < index; ++i) {
+    auto space = value.find(' ');
+    if (space == std::string_view::npos) {
+      return std::nullopt;
+    }
+    value.remove_prefix(space + 1);
+  }
+  return value.substr(0, value.find(' '));
+}
+
+}  // namespace
+
+std::string_view SdpLine::attribute_name() const {
+  return value.substr(0, value.find(':'));
+}
+
+std::string_view SdpLine::attribute_value() const {
+  auto colon = value.find(':');
+  return colon == std::string_view::npos ? std::string_view() : value.substr(colon + 1);
+}
+
+void SdpLines::iterator::advance() {
+  if (rest_.empty()) {
+    line_ = {};
+    done_ = true;
+    return;
+  }
+  auto end = rest_.find('\n');
+  auto text = rest_.substr(0, end);
+  rest_.remove_prefix(end == std::string_view::npos ? rest_.size() : end + 1);
+  if (text.ends_with('\r')) {
+    text.remove_suffix(1);
+  }
+  line_ = {.text = text};
+  if (text.size() >= 2 && text[1] == '=') {
+    line_.type = text[0];
+    line_.value = text.substr(2);
+  }
+  done_ = false;
+}
+
+std::string_view SdpSection::media() const {
+  if (!text_.starts_with("m=")) {
+    return {};
+  }
+  auto value = text_.substr(2);
+  return value.substr(0, value.find_first_of(" \r\n"));
+}
+
+std::optional<std::string_view> SdpSection::attribute(std::string_view name) const {
+  for (const auto& line : lines()) {
+    if (line.is_attribute() && line.attribute_name() == name) {
+      return line.attribute_value();
+    }
+  }
+  return std::nullopt;
+}
+
+void SdpView::MediaSections::iterator::advance() {
+  if (rest_.empty()) {
+    section_ = {};
+    return;
+  }
+  auto next = find_media_line(rest_, 1);
+  auto end = next == std::string_view::npos ? rest_.size() : next;
+  section_ = SdpSection(rest_.substr(0, end));
+  rest_.remove_prefix(end);
+}
+
+SdpView::SdpView(std::string_view sdp) : sdp_(sdp) {
+  auto start = find_media_line(sdp_, 0);
+  media_start_ = start == std::string_view::npos ? sdp_.size() : start;
+}
+
+std::size_t SdpView::media_count() const {
+  std::size_t count = 0;
+  for ([[maybe_unused]] const auto& section : media_sections()) {
+    ++count;
+  }
+  return count;
+}
+
+bool SdpView::well_formed() const {
+  bool first = true;
+  for (const auto& line : lines()) {
+    if (line.type == '\0' || (first && line.type != 'v')) {
+      return false;
+    }
+    first = false;
+  }
+  return !first;
+}
+
+std::optional<std::string_view> SdpView::attribute(std::string_view name) const {
+  if (auto value = session().attribute(name)) {
+    return value;
+  }
+  for (const auto& section : media_sections()) {
+    if (auto value = section.attribute(name)) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string_view> SdpView::session_id() const {
+  for (const auto& line : session().lines()) {
+    if (line.type == 'o') {
+      // o=<username> <sess-id> <sess-version> <nettype> <addrtype> <address>
+      return field(line.value, 1);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<int> SdpView::sctp_port() const {
+  auto value = attribute("sctp-port");
+  if (!value) {
+    return std::nullopt;
+  }
+  int port = 0;
+  auto [end, ec] = std::from_chars(value->data(), value->data() + value->size(), port);
+  if (ec != std::errc() || end != value->data() + value->size()) {
+    return std::nullopt;
+  }
+  return port;
+}
+
+SdpEditor& SdpEditor::set_attribute(std::string_view name, std::string value) {
+  edits_.push_back({.name = std::string(name), .value = std::move(value)});
+  return *this;
+}
+
+SdpEditor& SdpEditor::transform_attribute(std::string_view name, AttributeTransform transform) {
+  edits_.push_back({.name = std::string(name), .transform = std::move(transform)});
+  return *this;
+}
+
+SdpEditor& SdpEditor::remove_attribute(std::string_view name) {
+  edits_.push_back({.name = std::string(name)});
+  return *this;
+}
+
+SdpEditor& SdpEditor::add_session_attribute(std::string_view name, std::string_view value) {
+  return add_attribute_line(std::nullopt, name, value);
+}
+
+SdpEditor& SdpEditor::add_media_attribute(std::size_t media_index, std::string_view name,
+                                          std::string_view value) {
+  return add_attribute_line(media_index, name, value);
+}
+
+SdpEditor& SdpEditor::add_attribute_line(std::optional<std::size_t> media_index,
+                                          std::string_view name, std::string_view value) {
+  std::string line = "a=";
+  line += name;
+  if (!value.empty()) {
+    line += ':';
+    line += value;
+  }
+  added_.push_back({.media_index = media_index, .line = std::move(line)});
+  return *this;
+}
+
+SdpEditor& SdpEditor::set_session_id(std::string session_id) {
+  session_id_ = std::move(session_id);
+  return *this;
+}
+
+std::string SdpEditor::build() const {
+  std::string out;
+  build_into(out);
+  return out;
+}
+
+void SdpEditor::build_into(std::string& out) const {
+  out.clear();
+  out.reserve(sdp_.size() + 64);
+
+  std::optional<std::size_t> media_index;  // Session section while unset.
+  std::string transformed;
+  for (const auto& line : SdpLines(sdp_)) {
+    if (line.type == 'm') {
+      append_added(out, media_index);
+      media_index = media_index ? *media_index + 1 : 0;
+    }
+
+    if (line.type == 'o' && session_id_ && !media_index) {
+      auto start = line.text.find(' ');
+      auto end = start == std::string_view::npos ? start : line.text.find(' ', start + 1);
+      if (end != std::string_view::npos) {
+        out += line.text.substr(0, start + 1);
+        out += *session_id_;
+        out += line.text.substr(end);
+        out += kLineEnd;
+        continue;
+      }
+    }
+
+    if (line.is_attribute() && !edits_.empty()) {
+      auto name = line.attribute_name();
+      auto value = line.attribute_value();
+      bool edited = false;
+      bool removed = false;
+      for (const auto& edit : edits_) {
+        if (edit.name != name) {
+          continue;
+        }
+        if (edit.transform) {
+          transformed = edit.transform(value);
+          value = transformed;
+        } else if (edit.value) {
+          value = *edit.value;
+        } else {
+          removed = true;
+          break;
+        }
+        edited = true;
+      }
+      if (removed) {
+        continue;
+      }
+      if (edited) {
+        out += "a=";
+        out += name;
+        if (!value.empty()) {
+          out += ':';
+          out += value;
+        }
+        out += kLineEnd;
+        continue;
+      }
+    }
+
+    out += line.text;
+    out += kLineEnd;
+  }
+  append_added(out, media_index);
+}
+
+void SdpEditor::append_added(std::string& out, std::optional<std::size_t> media_index) const {
+  for (const auto& added : added_) {
+    if (added.media_index == media_index) {
+      out += added.line;
+      out += kLineEnd;
+    }
+  }
+}
+
+}  // namespace librtc
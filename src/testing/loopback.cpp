@@ -0,0 +1,314 @@
+#include <rtc_base/fake_network.h>
+#include <rtc_base/socket_address.h>
+#include <rtc_base/thread.h>
+#include <rtc_base/virtual_socket_server.h>
+
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <algorithm>
+#include <librtc/errors/peer_connection_error.hpp>
+#include <librtc/testing/loopback.hpp>
+#include <librtc/utils/async_bridge.hpp>
+#include <librtc/utils/deadline.hpp>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "impl/rtc_context_impl.hpp"
+
+namespace librtc::testing {
+namespace {
+
+namespace asio = boost::asio;
+
+// One VirtualSocketServer serving as the network thread's socket server, socket factory
+// and (through a fake network manager with a single interface) source of host
+// candidates.
+class VirtualShardNetwork : public ShardNetwork {
+ public:
+  explicit VirtualShardNetwork(const LoopbackNetworkConfig& config)
+      : server_(std::make_unique<webrtc::VirtualSocketServer>()) {
+    server_->set_delay_mean(static_cast<std::uint32_t>(config.latency.count()));
+    server_->set_delay_stddev(static_cast<std::uint32_t>(config.jitter.count()));
+    server_->UpdateDelayDistribution();
+    server_->set_bandwidth(config.bandwidth_bytes_per_sec);
+    server_->set_drop_probability(config.loss);
+  }
+
+  std::unique_ptr<webrtc::Thread> create_network_thread(
+      [[maybe_unused]] std::size_t index) override {
+    return std::make_unique<webrtc::Thread>(server_.get());
+  }
+
+  void add_dependencies([[maybe_unused]] webrtc::Thread* network_thread,
+                        webrtc::PeerConnectionFactoryDependencies& deps) override {
+    auto network_manager = std::make_unique<webrtc::FakeNetworkManager>();
+    network_manager->AddInterface(webrtc::SocketAddress("10.0.0.1", 0));
+    deps.network_manager = std::move(network_manager);
+    deps.socket_factory = server_.get();
+  }
+
+ private:
+  std::unique_ptr<webrtc::VirtualSocketServer> server_;
+};
+
+bool valid_network_config(const LoopbackNetworkConfig& config) {
+  return config.latency.count() >= 0 && config.jitter.count() >= 0 && config.loss >= 0 &&
+         config.loss <= 1;
+}
+
+bool ice_connected(IceConnectionState state) {
+  return state == IceConnectionState::Connected || state == IceConnectionState::Completed;
+}
+
+bool ice_failed(IceConnectionState state) {
+  return state == IceConnectionState::Failed || state == IceConnectionState::Closed;
+}
+
+// Bounds one step of make_loopback_pair by the time left until deadline.
+template <typename T, typename E>
+asio::awaitable<Result<T, E>> before_deadline(asio::awaitable<Result<T, E>> operation,
+                                              std::chrono::steady_clock::time_point deadline) {
+  auto remaining =
+      std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+  if (remaining.count() <= 0) {
+    co_return Err(PeerConnectionError::Timeout);
+  }
+  co_return co_await with_timeout(std::move(operation), remaining, PeerConnectionError::Timeout);
+}
+
+// Progress of the pair, recorded by event handlers (which run on WebRTC threads unless
+// the peers deliver events to the executor) and consumed by make_loopback_pair.
+struct Signaling : std::enable_shared_from_this<Signaling> {
+  using Clock = std::chrono::steady_clock;
+  using Waiter = AsyncBridge<void, PeerConnectionError>::Completion;
+
+  // Runs fn under the mutex and wakes make_loopback_pair.
+  template <typename F>
+  void update(F&& fn) {
+    Waiter woken;
+    {
+      std::lock_guard lock(mutex);
+      fn();
+      changed = true;
+      woken = std::move(waiter);
+    }
+    if (woken) {
+      woken(Success());
+    }
+  }
+
+  // Records the first time ICE of pc connects, timestamped in the handler.
+  Subscription watch_ice(PeerConnection& pc, std::optional<Clock::time_point> Signaling::*at) {
+    return pc.on_ice_connection_state_change().subscribe(
+        weak_from_this(), [at](Signaling& s, IceConnectionState state) {
+          if (ice_connected(state)) {
+            s.update([&] { mark(s.*at); });
+          } else if (ice_failed(state)) {
+            s.update([&] { s.failed = true; });
+          }
+        });
+  }
+
+  // Records the first time channel is open, timestamped in the handler.
+  Subscription watch_open(DataChannel& channel, std::optional<Clock::time_point> Signaling::*at) {
+    auto subscription = channel.on_state_change().subscribe(
+        weak_from_this(), [at](Signaling& s, DataChannelState state) {
+          if (state == DataChannelState::Open) {
+            s.update([&] { mark(s.*at); });
+          }
+        });
+    // The channel may have opened before the subscription.
+    if (channel.state() == DataChannelState::Open) {
+      update([&] { mark(this->*at); });
+    }
+    return subscription;
+  }
+
+  static void mark(std::optional<Clock::time_point>& at) {
+    if (!at) {
+      at = Clock::now();
+    }
+  }
+
+  std::mutex mutex;
+  std::vector<IceCandidate> to_offerer;
+  std::vector<IceCandidate> to_answerer;
+  std::shared_ptr<DataChannel> answerer_channel;
+  Subscription answerer_channel_state;
+  std::optional<Clock::time_point> offerer_connected;
+  std::optional<Clock::time_point> answerer_connected;
+  std::optional<Clock::time_point> offerer_open;
+  std::optional<Clock::time_point> answerer_open;
+  bool failed = false;
+  // Set by every update and cleared when make_loopback_pair takes the state, so an
+  // update between taking it and suspending is not missed.
+  bool changed = false;
+  Waiter waiter;
+};
+
+}  // namespace
+
+Expected<std::shared_ptr<RtcContext>> make_loopback_context(const LoopbackNetworkConfig& network,
+                                                            RtcContextConfig config) {
+  if (!valid_network_config(network)) {
+    return Err(PeerConnectionError::InvalidArgument);
+  }
+  config.shard_count = 1;
+  auto impl_result = RtcContextImpl::Create(config, std::make_shared<VirtualShardNetwork>(network));
+  if (!impl_result) {
+    return Err(impl_result.error());
+  }
+  return std::shared_ptr<RtcContext>(impl_result.value());
+}
+
+asio::awaitable<Expected<LoopbackPair>> make_loopback_pair(std::shared_ptr<RtcContext> context,
+                                                           LoopbackPairConfig config) {
+  auto executor = co_await asio::this_coro::executor;
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + config.timeout;
+
+  auto offerer = PeerConnection::Create(context, executor, config.peer);
+  if (!offerer) {
+    co_return Err(offerer.error());
+  }
+  auto answerer = PeerConnection::Create(context, executor, config.peer);
+  if (!answerer) {
+    co_return Err(answerer.error());
+  }
+  LoopbackPair pair{.context = std::move(context),
+                    .offerer = std::move(offerer).value(),
+                    .answerer = std::move(answerer).value()};
+  pair.create_time = std::chrono::steady_clock::now() - start;
+
+  auto signaling = std::make_shared<Signaling>();
+  std::weak_ptr<Signaling> tracker = signaling;
+  std::vector<Subscription> subscriptions;
+  auto forward = [](std::vector<IceCandidate> Signaling::*outbox) {
+    return [outbox](Signaling& s, const IceCandidateBatch& batch) {
+      s.update([&] {
+        (s.*outbox).insert((s.*outbox).end(), batch.candidates.begin(), batch.candidates.end());
+      });
+    };
+  };
+  subscriptions.push_back(
+      pair.offerer->on_ice_candidates().subscribe(tracker, forward(&Signaling::to_answerer)));
+  subscriptions.push_back(
+      pair.answerer->on_ice_candidates().subscribe(tracker, forward(&Signaling::to_offerer)));
+  subscriptions.push_back(signaling->watch_ice(*pair.offerer, &Signaling::offerer_connected));
+  subscriptions.push_back(signaling->watch_ice(*pair.answerer, &Signaling::answerer_connected));
+  subscriptions.push_back(pair.answerer->on_data_channel().subscribe(
+      tracker, [](Signaling& s, std::shared_ptr<DataChannel> channel) {
+        auto state = s.watch_open(*channel, &Signaling::answerer_open);
+        s.update([&] {
+          s.answerer_channel = std::move(channel);
+          s.answerer_channel_state = std::move(state);
+        });
+      }));
+
+  auto channel = pair.offerer->create_data_channel(config.channel_label, config.channel);
+  if (!channel) {
+    co_return Err(channel.error());
+  }
+  pair.offerer_channel = std::move(channel).value();
+  subscriptions.push_back(signaling->watch_open(*pair.offerer_channel, &Signaling::offerer_open));
+
+  auto offer = co_await before_deadline(pair.offerer->offer_and_set_local(), deadline);
+  if (!offer) {
+    co_return Err(offer.error());
+  }
+  if (auto set = co_await before_deadline(
+          pair.answerer->set_remote_description(std::move(offer).value()), deadline);
+      !set) {
+    co_return Err(set.error());
+  }
+  auto answer = co_await before_deadline(pair.answerer->answer_and_set_local(), deadline);
+  if (!answer) {
+    co_return Err(answer.error());
+  }
+  if (auto set = co_await before_deadline(
+          pair.offerer->set_remote_description(std::move(answer).value()), deadline);
+      !set) {
+    co_return Err(set.error());
+  }
+
+  std::vector<IceCandidate> to_offerer;
+  std::vector<IceCandidate> to_answerer;
+  while (true) {
+    std::optional<Signaling::Clock::time_point> connected_at;
+    std::optional<Signaling::Clock::time_point> open_at;
+    bool failed = false;
+    {
+      std::lock_guard lock(signaling->mutex);
+      signaling->changed = false;
+      std::swap(to_offerer, signaling->to_offerer);
+      std::swap(to_answerer, signaling->to_answerer);
+      if (!pair.answerer_channel) {
+        pair.answerer_channel = signaling->answerer_channel;
+      }
+      if (signaling->offerer_connected && signaling->answerer_connected) {
+        connected_at = std::max(*signaling->offerer_connected, *signaling->answerer_connected);
+      }
+      if (signaling->offerer_open && signaling->answerer_open) {
+        open_at = std::max(*signaling->offerer_open, *signaling->answerer_open);
+      }
+      failed = signaling->failed;
+    }
+    if (!to_answerer.empty()) {
+      auto added =
+          co_await before_deadline(pair.answerer->add_ice_candidates(to_answerer), deadline);
+      if (!added) {
+        co_return Err(added.error());
+      }
+      to_answerer.clear();
+    }
+    if (!to_offerer.empty()) {
+      auto added = co_await before_deadline(pair.offerer->add_ice_candidates(to_offerer), deadline);
+      if (!added) {
+        co_return Err(added.error());
+      }
+      to_offerer.clear();
+    }
+
+    // The answerer's channel can report open just before it is handed over.
+    if (connected_at && open_at && pair.answerer_channel) {
+      pair.connect_time = *connected_at - start;
+      pair.open_time = *open_at - start;
+      co_return std::move(pair);
+    }
+    if (failed) {
+      co_return Err(PeerConnectionError::NetworkError);
+    }
+
+    auto woken = co_await before_deadline(
+        AsyncBridge<void, PeerConnectionError>::async_run(
+            executor,
+            [signaling](auto cb) {
+              {
+                std::lock_guard lock(signaling->mutex);
+                if (!signaling->changed) {
+                  signaling->waiter = std::move(cb);
+                  return;
+                }
+              }
+              cb(Success());
+            },
+            asio::use_awaitable),
+        deadline);
+    if (!woken) {
+      co_return Err(woken.error());
+    }
+  }
+}
+
+asio::awaitable<Expected<LoopbackPair>> make_loopback_pair(LoopbackNetworkConfig network,
+                                                           LoopbackPairConfig config) {
+  auto context = make_loopback_context(network, {.profile = FactoryProfile::DataOnly});
+  if (!context) {
+    co_return Err(context.error());
+  }
+  co_return co_await make_loopback_pair(std::move(context).value(), std::move(config));
+}
+
+}  // namespace librtc::testing